@@ -0,0 +1,80 @@
+#include "arena.h"
+#include "list.h"
+#include "player.h"
+#include "prototype.h"
+#include "scene.h"
+#include "sdl_wrapper.h"
+#include "vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Soak-tests the engine headless with growing numbers of bots playing slyce's
+// rules (see arena.h): eating pellets, growing, shooting and respawning.
+// Each tick is arena_tick(), exactly what slyce runs every tick of a game.
+// Reports the time per tick, as a share of slyce's 10 ms (100 Hz) tick too,
+// and how many bodies the scene holds, which should stay bounded however long
+// the bots play.
+
+const vector_t ARENA_MIN = {.x = 0, .y = 0};
+const vector_t ARENA_MAX = {.x = 1600, .y = 900};
+const double BENCH_DT = 0.01; // slyce's tick length
+const size_t BENCH_TICKS = 3000;
+const size_t BOT_COUNTS[] = {4, 16, 32, 64, 128};
+// more pellets than slyce spawns, so that many bots keep finding food
+const size_t PELLETS_PER_BOT = 3;
+const size_t PELLET_SPAWN_TICKS = 50;
+
+arena_t *bench_arena_init(size_t bot_count) {
+  arena_t *arena = arena_init(ARENA_MIN, ARENA_MAX);
+  for (size_t i = 0; i < bot_count; i++) {
+    arena_add_bot(arena);
+  }
+  for (size_t i = 0; i < PELLETS_PER_BOT * bot_count; i++) {
+    arena_spawn_pellet(arena);
+  }
+  return arena;
+}
+
+void bench_arena_tick(arena_t *arena, size_t tick) {
+  if (tick % PELLET_SPAWN_TICKS == 0) {
+    arena_spawn_pellet(arena);
+  }
+  arena_tick(arena, BENCH_DT);
+}
+
+int main(void) {
+  printf("%6s %10s %8s %12s %12s %14s\n", "bots", "ms/tick", "budget",
+         "avg bodies", "max bodies", "longest slug");
+  powerups_load_sounds();
+  for (size_t i = 0; i < sizeof(BOT_COUNTS) / sizeof(size_t); i++) {
+    srand(i);
+    arena_t *arena = bench_arena_init(BOT_COUNTS[i]);
+    size_t total_bodies = 0;
+    size_t max_bodies = 0;
+    clock_t start = clock();
+    for (size_t tick = 0; tick < BENCH_TICKS; tick++) {
+      bench_arena_tick(arena, tick);
+      size_t bodies = scene_bodies(arena_get_scene(arena));
+      total_bodies += bodies;
+      max_bodies = bodies > max_bodies ? bodies : max_bodies;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    size_t longest = 0;
+    list_t *players = arena_get_players(arena);
+    for (size_t j = 0; j < list_size(players); j++) {
+      player_t *player = list_get(players, j);
+      size_t length = list_size(player->meta_bodies);
+      longest = length > longest ? length : longest;
+    }
+    double tick_seconds = seconds / BENCH_TICKS;
+    printf("%6zu %10.3f %7.1f%% %12.1f %12zu %14zu\n", BOT_COUNTS[i],
+           tick_seconds * 1e3, tick_seconds / BENCH_DT * 100,
+           (double)total_bodies / BENCH_TICKS, max_bodies, longest);
+    arena_free(arena);
+  }
+  sdl_free_sounds();
+  prototype_free_all();
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include "body.h"
+#include "collision.h"
+#include "contact.h"
+#include "list.h"
+#include "scene.h"
+#include "utils.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Measures the cost of the contact solver per touching contact per tick
+// on a pile of boxes resting on a static floor, for several iteration counts.
+
+const size_t PILE_COLUMNS = 10;
+const size_t PILE_ROWS = 10;
+const double BOX_SIZE = 20;
+const double BOX_MASS = 10;
+const double BOX_ELASTICITY = 0.1;
+const double GRAVITY = 500;
+const double BENCH_DT = 0.01;
+const size_t BENCH_TICKS = 1000;
+const size_t ITERATION_COUNTS[] = {1, 2, 4, 8, 16};
+const color_t BOX_COLOR = (color_t){.r = 1, .g = 1, .b = 1, .a = 1};
+
+/** Builds the pile and returns the (non-owning) list of its contacts */
+list_t *build_pile(scene_t *scene) {
+  list_t *contacts = list_init(2 * PILE_COLUMNS * PILE_ROWS, NULL);
+  double width = PILE_COLUMNS * BOX_SIZE;
+  body_t *floor =
+      body_init(make_rectangle(2 * width, BOX_SIZE, (vector_t){0, 0}),
+                INFINITY, BOX_COLOR);
+  scene_add_body(scene, floor);
+
+  body_t *boxes[PILE_ROWS][PILE_COLUMNS];
+  for (size_t row = 0; row < PILE_ROWS; row++) {
+    for (size_t col = 0; col < PILE_COLUMNS; col++) {
+      // boxes start slightly apart so they settle onto each other
+      vector_t center = {.x = (col + 0.5) * BOX_SIZE - width / 2,
+                         .y = (row + 1) * BOX_SIZE * 1.05};
+      body_t *box = body_init(make_rectangle(BOX_SIZE, BOX_SIZE, center),
+                              BOX_MASS, BOX_COLOR);
+      scene_add_body(scene, box);
+      boxes[row][col] = box;
+    }
+  }
+
+  for (size_t row = 0; row < PILE_ROWS; row++) {
+    for (size_t col = 0; col < PILE_COLUMNS; col++) {
+      // no diagonal contacts: boxes can now rotate, and an exactly
+      // aligned corner-to-corner contact would tip them over
+      body_t *neighbors[2] = {row == 0 ? floor : boxes[row - 1][col],
+                              col == 0 ? NULL : boxes[row][col - 1]};
+      for (size_t i = 0; i < 2; i++) {
+        if (neighbors[i] == NULL) {
+          continue;
+        }
+        contact_t *contact =
+            contact_init(neighbors[i], boxes[row][col], BOX_ELASTICITY);
+        scene_add_contact(scene, contact);
+        list_add(contacts, contact);
+      }
+    }
+  }
+  return contacts;
+}
+
+double max_penetration(list_t *contacts) {
+  double max_depth = 0;
+  for (size_t i = 0; i < list_size(contacts); i++) {
+    contact_t *contact = list_get(contacts, i);
+    list_t *shape1 = body_get_shape(contact_get_body1(contact));
+    list_t *shape2 = body_get_shape(contact_get_body2(contact));
+    collision_info_t info = find_collision(shape1, shape2);
+    if (info.collided && info.depth > max_depth) {
+      max_depth = info.depth;
+    }
+    list_free(shape1);
+    list_free(shape2);
+  }
+  return max_depth;
+}
+
+int main(void) {
+  printf("%10s %12s %14s %16s\n", "iterations", "avg contacts", "ns/contact",
+         "max penetration");
+  for (size_t i = 0; i < sizeof(ITERATION_COUNTS) / sizeof(size_t); i++) {
+    scene_t *scene = scene_init();
+    list_t *contacts = build_pile(scene);
+    scene_set_solver_iterations(scene, ITERATION_COUNTS[i]);
+
+    size_t touching = 0;
+    clock_t solver_clocks = 0;
+    // steps the pile like scene_tick_canon(), timing only the solver stage
+    for (size_t tick = 0; tick < BENCH_TICKS; tick++) {
+      for (size_t j = 0; j < scene_bodies(scene); j++) {
+        body_t *body = scene_get_body(scene, j);
+        if (body_get_mass(body) != INFINITY) {
+          body_add_force(body, (vector_t){.x = 0,
+                                          .y = -GRAVITY * BOX_MASS});
+        }
+      }
+
+      clock_t start = clock();
+      scene_solve_contacts(scene, BENCH_DT);
+      solver_clocks += clock() - start;
+
+      for (size_t j = 0; j < list_size(contacts); j++) {
+        touching += contact_is_touching(list_get(contacts, j));
+      }
+      for (size_t j = 0; j < scene_bodies(scene); j++) {
+        body_tick_canon(scene_get_body(scene, j), BENCH_DT);
+      }
+    }
+
+    double avg_touching = (double)touching / BENCH_TICKS;
+    double seconds = (double)solver_clocks / CLOCKS_PER_SEC;
+    double ns_per_contact = touching == 0 ? 0 : seconds * 1e9 / touching;
+    printf("%10zu %12.1f %14.1f %16.3f\n", ITERATION_COUNTS[i], avg_touching,
+           ns_per_contact, max_penetration(contacts));
+    list_free(contacts);
+    scene_free(scene);
+  }
+  return 0;
+}
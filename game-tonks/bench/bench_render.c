@@ -0,0 +1,163 @@
+#include "body.h"
+#include "list.h"
+#include "prototype.h"
+#include "scene.h"
+#include "sdl_wrapper.h"
+#include "snapshot.h"
+#include "text.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Measures the time to draw a frame with each offscreen renderer,
+// on scenes recorded once into snapshots and redrawn every frame.
+// Pass a directory to also save each scene's last frame there as a PNG,
+// e.g. to compare the renderers' output.
+
+const vector_t BENCH_MIN = {.x = 0, .y = 0};
+const vector_t BENCH_MAX = {.x = 1600, .y = 900};
+const int FRAME_WIDTH = 1600;
+const int FRAME_HEIGHT = 900;
+const size_t BENCH_FRAMES = 50;
+const size_t PELLET_COUNT = 2000;
+const double PELLET_RADIUS = 6;
+const size_t SEGMENT_COUNT = 300;
+const double SEGMENT_RADIUS = 15;
+const double SEGMENT_GLOW_RADIUS = 20;
+const size_t STAR_COUNT = 300;
+const size_t STAR_POINTS = 5;
+const double STAR_RADIUS = 25;
+const size_t TEXT_COUNT = 40;
+const double TEXT_HEIGHT = 20;
+const double TEXT_WIDTH = 16;
+const size_t TEXT_MAX_LEN = 32;
+const renderer_type_t RENDERERS[] = {RENDERER_SDL, RENDERER_SOFTWARE};
+const char *RENDERER_NAMES[] = {"sdl", "software"};
+
+typedef void (*scene_builder_t)(scene_t *scene);
+
+vector_t random_position(void) {
+  return (vector_t){.x = BENCH_MIN.x + (BENCH_MAX.x - BENCH_MIN.x) * rand() /
+                                           RAND_MAX,
+                    .y = BENCH_MIN.y + (BENCH_MAX.y - BENCH_MIN.y) * rand() /
+                                           RAND_MAX};
+}
+
+color_t random_color(double alpha) {
+  return (color_t){.r = (double)rand() / RAND_MAX,
+                   .g = (double)rand() / RAND_MAX,
+                   .b = (double)rand() / RAND_MAX,
+                   .a = alpha};
+}
+
+/** Food pellets: many small, opaque prototype bodies */
+void build_pellets(scene_t *scene) {
+  prototype_t *pellet = prototype_get_round(6, PELLET_RADIUS);
+  for (size_t i = 0; i < PELLET_COUNT; i++) {
+    scene_add_body(scene, body_init_with_prototype(pellet, random_position(),
+                                                   1, random_color(1), NULL,
+                                                   NULL));
+  }
+}
+
+/** Slug segments: larger, translucent prototype bodies that glow */
+void build_segments(scene_t *scene) {
+  prototype_t *segment = prototype_get_round(20, SEGMENT_RADIUS);
+  for (size_t i = 0; i < SEGMENT_COUNT; i++) {
+    body_t *body = body_init_with_prototype(
+        segment, random_position(), 1, random_color(0.7), NULL, NULL);
+    body_set_glow(body, true);
+    body_set_glow_radius(body, SEGMENT_GLOW_RADIUS);
+    scene_add_body(scene, body);
+  }
+}
+
+/** Stars: concave polygon bodies, which have to be triangulated */
+void build_stars(scene_t *scene) {
+  for (size_t i = 0; i < STAR_COUNT; i++) {
+    vector_t center = random_position();
+    list_t *shape = list_init(2 * STAR_POINTS, free);
+    for (size_t j = 0; j < 2 * STAR_POINTS; j++) {
+      double angle = M_PI * j / STAR_POINTS;
+      double radius = j % 2 == 0 ? STAR_RADIUS : STAR_RADIUS / 2;
+      vector_t *point = malloc(sizeof(vector_t));
+      *point = vec_add(center, vec_multiply(radius, (vector_t){cos(angle),
+                                                               sin(angle)}));
+      list_add(shape, point);
+    }
+    scene_add_body(scene, body_init(shape, 1, random_color(1)));
+  }
+}
+
+/** Lines of text, like the menu and the scoreboard */
+void build_texts(scene_t *scene) {
+  for (size_t i = 0; i < TEXT_COUNT; i++) {
+    vector_t center = {.x = FRAME_WIDTH / 2.0,
+                       .y = (i + 0.5) * FRAME_HEIGHT / TEXT_COUNT};
+    // the text takes ownership of the string
+    char *line = malloc(TEXT_MAX_LEN);
+    snprintf(line, TEXT_MAX_LEN, "PLAYER %zu: %d", i + 1, rand() % 10000);
+    scene_add_text(scene, text_init(line, center, TEXT_HEIGHT, TEXT_WIDTH,
+                                    random_color(1), INFINITY));
+  }
+}
+
+const char *SCENE_NAMES[] = {"pellets", "segments", "stars", "texts"};
+const scene_builder_t SCENE_BUILDERS[] = {build_pellets, build_segments,
+                                          build_stars, build_texts};
+
+int main(int argc, char *argv[]) {
+  const char *frame_dir = argc > 1 ? argv[1] : NULL;
+  size_t scene_count = sizeof(SCENE_BUILDERS) / sizeof(scene_builder_t);
+  size_t renderer_count = sizeof(RENDERERS) / sizeof(renderer_type_t);
+
+  // record every scene once, so each renderer draws exactly the same frames
+  snapshot_t *recordings[scene_count];
+  scene_t *scenes[scene_count];
+  for (size_t i = 0; i < scene_count; i++) {
+    srand(i);
+    scenes[i] = scene_init();
+    SCENE_BUILDERS[i](scenes[i]);
+    recordings[i] = snapshot_init();
+    snapshot_clear(recordings[i], 0);
+    snapshot_add_glows(recordings[i], scenes[i]);
+    snapshot_add_bodies(recordings[i], scenes[i]);
+    snapshot_add_texts(recordings[i], scenes[i]);
+  }
+
+  printf("%10s %10s %12s\n", "scene", "renderer", "ms/frame");
+  for (size_t r = 0; r < renderer_count; r++) {
+    sdl_init_offscreen(BENCH_MIN, BENCH_MAX, FRAME_WIDTH, FRAME_HEIGHT,
+                       RENDERERS[r]);
+    for (size_t i = 0; i < scene_count; i++) {
+      clock_t start = clock();
+      for (size_t frame = 0; frame < BENCH_FRAMES; frame++) {
+        sdl_begin_frame();
+        snapshot_draw(NULL, recordings[i], 1);
+        sdl_end_frame();
+      }
+      double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+      printf("%10s %10s %12.3f\n", SCENE_NAMES[i], RENDERER_NAMES[r],
+             seconds * 1e3 / BENCH_FRAMES);
+
+      if (frame_dir != NULL) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s_%s.png", frame_dir,
+                 SCENE_NAMES[i], RENDERER_NAMES[r]);
+        if (!sdl_save_frame(path)) {
+          printf("Could not save %s\n", path);
+        }
+      }
+    }
+    sdl_free();
+  }
+
+  for (size_t i = 0; i < scene_count; i++) {
+    snapshot_free(recordings[i]);
+    scene_free(scenes[i]);
+  }
+  prototype_free_all();
+  return 0;
+}
@@ -1,12 +1,12 @@
+#include "arena.h"
 #include "body.h"
 #include "text.h"
-#include "collision.h"
 #include "color.h"
-#include "forces.h"
 #include "list.h"
 #include "polygon.h"
 #include "scene.h"
 #include "sdl_wrapper.h"
+#include "snapshot.h"
 #include "state.h"
 #include "vector.h"
 #include "player.h"
@@ -21,52 +21,29 @@
 #include <string.h>
 #include <time.h>
 
-// physics constants
-#define SPRING_CONST 8000.0
-#define DRAG_CONST 1000.0
-
 // window constants
 const vector_t WINDOW = (vector_t){.x = 1600, .y = 900};
 const vector_t CENTER = (vector_t){.x = 800, .y = 450};
 const vector_t MIN_POSITION = (vector_t){.x = 0, .y = 0};
 
-// wall constants
-const double WALL_THICKNESS = 10;
-const double WALL_MASS = INFINITY;
-const size_t WALL_LEFT_BODIES_INDEX = 2;
-const size_t WALL_TOP_BODIES_INDEX = 3;
-const size_t WALL_RIGHT_BODIES_INDEX = 4;
-const double WALL_IMPULSE = 80000;
-const color_t WALL_COLOR = (color_t){.r = 0.3, .g = 0.3, .b = 0.3, .a = 1};
-
 // game constants
-const size_t GAME_NUM_PLAYERS = 4;
-const double PLAYER_COLLISION_IMPULSE = 100;
+// slugs played by bots, joining the players at the keyboard; their number is
+// chosen on the menu with the up and down arrows. A tick keeps well within
+// its 10 ms with 64 and more of them (see bench/bench_bots.c)
+const size_t GAME_NUM_BOTS_DEFAULT = 4;
+const size_t GAME_MAX_BOTS = 128;
 const size_t INFO_MAX_LEN = 100;
 const double dt = 0.01;
 
 // color constants
 const color_t COLOR_WHITE = (color_t) {1, 1, 1, 1};
 
-const color_t COLOR_PLAYER1_CHOICE1 = (color_t){255 / 255.0, 147 / 255.0, 140 / 255.0, 1};
-const color_t COLOR_PLAYER1_CHOICE2 = (color_t){234 / 255.0, 210 / 255.0, 172 / 255.0, 1};
-const color_t COLOR_PLAYER1_CHOICE3 = (color_t){156 / 255.0, 175 / 255.0, 183 / 255.0, 1};
-const color_t COLOR_PLAYER1_CHOICE4 = (color_t){181 / 255.0, 217 / 255.0, 156 / 255.0, 1};
-
-const color_t COLOR_PLAYER2_CHOICE1 = (color_t){128 / 255.0, 35 / 255.0, 146 / 255.0, 1};
-const color_t COLOR_PLAYER2_CHOICE2 = (color_t){165 / 255.0, 248 / 255.0, 211 / 255.0, 1};
-const color_t COLOR_PLAYER2_CHOICE3 = (color_t){99 / 255.0, 210 / 255.0, 255.0 / 255.0, 1};
-const color_t COLOR_PLAYER2_CHOICE4 = (color_t){249 / 255.0, 0 / 255.0, 147 / 255.0, 1};
-
-const color_t COLOR_PLAYER3_CHOICE1 = (color_t){15 / 255.0, 29 / 255.0, 115 / 255.0, 1};
-const color_t COLOR_PLAYER3_CHOICE2 = (color_t){44 / 255.0, 103 / 255.0, 186 / 255.0, 1};
-const color_t COLOR_PLAYER3_CHOICE3 = (color_t){75 / 255.0, 166 / 255.0, 179 / 255.0, 1};
-const color_t COLOR_PLAYER3_CHOICE4 = (color_t){106 / 255.0, 221 / 255.0, 128 / 255.0, 1};
-
-const color_t COLOR_PLAYER4_CHOICE1 = (color_t){232 / 255.0, 223 / 255.0, 24 / 255.0, 1};
-const color_t COLOR_PLAYER4_CHOICE2 = (color_t){252 / 255.0, 225 / 255.0, 228 / 255.0, 1};
-const color_t COLOR_PLAYER4_CHOICE3 = (color_t){165 / 255.0, 213 / 255.0, 213 / 255.0, 1};
-const color_t COLOR_PLAYER4_CHOICE4 = (color_t){176 / 255.0, 203 / 255.0, 246 / 255.0, 1};
+// the colors each player at the keyboard can choose from on the menu
+const color_t PLAYER_COLOR_CHOICES[][4] = {
+    {{255 / 255.0, 147 / 255.0, 140 / 255.0, 1}, {234 / 255.0, 210 / 255.0, 172 / 255.0, 1}, {156 / 255.0, 175 / 255.0, 183 / 255.0, 1}, {181 / 255.0, 217 / 255.0, 156 / 255.0, 1}},
+    {{128 / 255.0, 35 / 255.0, 146 / 255.0, 1}, {165 / 255.0, 248 / 255.0, 211 / 255.0, 1}, {99 / 255.0, 210 / 255.0, 255.0 / 255.0, 1}, {249 / 255.0, 0 / 255.0, 147 / 255.0, 1}},
+    {{15 / 255.0, 29 / 255.0, 115 / 255.0, 1}, {44 / 255.0, 103 / 255.0, 186 / 255.0, 1}, {75 / 255.0, 166 / 255.0, 179 / 255.0, 1}, {106 / 255.0, 221 / 255.0, 128 / 255.0, 1}},
+    {{232 / 255.0, 223 / 255.0, 24 / 255.0, 1}, {252 / 255.0, 225 / 255.0, 228 / 255.0, 1}, {165 / 255.0, 213 / 255.0, 213 / 255.0, 1}, {176 / 255.0, 203 / 255.0, 246 / 255.0, 1}}};
 
 const color_t COLOR_BLACK = (color_t){0, 0, 0, 1};
 const color_t ERROR_COLOR = (color_t){1, 0, 0, 1};
@@ -77,10 +54,12 @@ const double TITLE_HEIGHT = 150;
 const double TITLE_WIDTH = 75;
 const double START_HEIGHT = 60;
 const double START_WIDTH = 30;
-const vector_t PLAYER_1_SETTINGS_CENTER = (vector_t){300, 700};
-const vector_t PLAYER_2_SETTINGS_CENTER = (vector_t){1300, 700};
-const vector_t PLAYER_3_SETTINGS_CENTER = (vector_t){300, 100};
-const vector_t PLAYER_4_SETTINGS_CENTER = (vector_t){1300, 100};
+// the players at the keyboard: their keys (left, right, dash and shoot),
+// the help text showing them and where their settings are on the menu
+const char PLAYER_KEYS[][4] = {{'q', 'e', 'w', 'r'}, {'u', 'o', 'i', 'p'}, {'z', 'c', 'x', 'v'}, {'b', 'm', 'n', ','}};
+const char *PLAYER_HELP_TEXTS[] = {"Q W E R", "U I O P", "Z X C V", "B N M <"};
+const vector_t PLAYER_SETTINGS_CENTERS[] = {{300, 700}, {1300, 700}, {300, 100}, {1300, 100}};
+const size_t GAME_NUM_HUMANS = sizeof(PLAYER_KEYS) / sizeof(PLAYER_KEYS[0]);
 const double PLAYER_TEXT_HEIGHT = 40;
 const double PLAYER_TEXT_WIDTH = 20;
 const double ERROR_TEXT_HEIGHT = 50;
@@ -90,6 +69,7 @@ const double HELP_HEIGHT = 30;
 const double HELP_WIDTH = 15;
 const color_t HELP_COLOR = (color_t){1, 1, 1, 0.4};
 const double HELP_OPACITY = 0.4;
+const vector_t BOTS_SETTING_CENTER = (vector_t){800, 780};
 
 // choices constants
 const double CHOICE_SIZE = 50;
@@ -100,8 +80,6 @@ const vector_t CHOICE_SPAWN_POSITION = (vector_t){0, -100};
 const double FOOD_MIN_SIZE_FACTOR = 0.5;
 const double FOOD_MAX_SIZE_FACTOR = 1;
 const size_t FOOD_COUNT_INITIAL = 13;
-const double FOOD_SIDE_LENGTH = 10;
-const double FOOD_SPAWN_TIME = 5;
 const time_t FOOD_FLASH_FREQUENCY = 1;
 const color_t FOOD_COLOR = (color_t){.r = 1, .g = 0.72, .b = 0.69, .a = 1};
 const size_t PTS_IN_PELLET = 4;
@@ -111,250 +89,52 @@ const int FREE_CHANNEL = -1;
 const int SECONDARY_CHANNEL = 0;
 const int REPEATED_SOUND_CHANNEL = 1;
 
+// image constants
+const char *BACKGROUND_PATH = "assets/background.bmp";
+// every sound effect played by the game, loaded once at startup,
+// except the powerups' (see powerups_load_sounds())
+const char *SOUND_PATHS[] = {
+    "assets/soundtrack.wav",   "assets/menu_select.wav",
+    "assets/menu_error.wav",   "assets/game_start.wav",
+    "assets/collide.wav",      "assets/dash.wav",
+    "assets/shoot.wav",        "assets/bullet_hit.wav",
+    "assets/death_dmg.wav",    "assets/death_scream.wav",
+    "assets/respawn.wav"};
+
 // state def
 typedef struct state
 {
-  scene_t *scene_game;
+  arena_t *arena; // the game, whose players are at the keyboard, then bots
   scene_t *scene_menu;
   text_t *timer;
+  size_t background;
+  snapshot_t *snapshot; // what to draw this frame
+  size_t num_bots;      // how many bots join the game when it starts
+  text_t *num_bots_tag; // shows num_bots on the menu
   bool sound_playing;
-  list_t *players;
   bool game_started;
   bool left_movement;
   bool right_movement;
   double time_since_dash;
   double game_time;
-  double time_since_pellet_spawn;
 } state_t;
 
-list_t *make_left_wall()
-{
-  return make_rectangle(WALL_THICKNESS, WINDOW.y,
-                        (vector_t){-0.5 * WALL_THICKNESS, CENTER.y});
-}
-
-list_t *make_bottom_wall()
-{
-  return make_rectangle(WINDOW.x, WALL_THICKNESS,
-                        (vector_t){CENTER.x, -0.5 * WALL_THICKNESS});
-}
-
-list_t *make_top_wall()
-{
-  return make_rectangle(WINDOW.x, WALL_THICKNESS,
-                        (vector_t){CENTER.x, WINDOW.y + 0.5 * WALL_THICKNESS});
-}
-
-list_t *make_right_wall()
-{
-  return make_rectangle(WALL_THICKNESS, WINDOW.y,
-                        (vector_t){WINDOW.x + 0.5 * WALL_THICKNESS, CENTER.y});
-}
-
-void wall_collision_handler(body_t *body1, body_t *body2, vector_t axis, void *aux)
-{
-  list_t *shape1 = body_get_shape(body1);
-  list_t *shape2 = body_get_shape(body2);
-  if (find_collision(shape1, shape2).collided)
-  {
-    char *info = malloc(sizeof(char) * INFO_MAX_LEN);
-    strcpy(info, list_get((list_t *)body_get_info(body2), 0));
-    if (strcmp(info, "wall_top") == 0)
-    {
-      vector_t velocity = (vector_t){.x = 0, .y = -WALL_IMPULSE};
-      body_add_impulse(body1, velocity);
-    }
-    else if (strcmp(info, "wall_bottom") == 0)
-    {
-      vector_t velocity = (vector_t){.x = 0, .y = WALL_IMPULSE};
-      body_add_impulse(body1, velocity);
-    }
-    else if (strcmp(info, "wall_left") == 0)
-    {
-      vector_t velocity = (vector_t){.x = WALL_IMPULSE, .y = 0};
-      body_add_impulse(body1, velocity);
-    }
-    else if (strcmp(info, "wall_right") == 0)
-    {
-      vector_t velocity = (vector_t){.x = -WALL_IMPULSE, .y = 0};
-      body_add_impulse(body1, velocity);
-    }
-  }
-  list_free(shape1);
-  list_free(shape2);
-}
-
-void player_collision_handler(body_t *body1, body_t *body2, vector_t axis, void *aux)
-{
-  state_t *state = (state_t *)aux;
-  if (list_size(state->players) > 0)
-  {
-    // assume body1 is the slug head
-    // and body2 is a metabody from slug 2
-    size_t player_id1 = *((size_t *)list_get((list_t *)body_get_info(body1), 1));
-    size_t player_id2 = *((size_t *)list_get((list_t *)body_get_info(body2), 1));
-    player_t *p1 = list_get(state->players, player_id1);
-    player_t *p2 = list_get(state->players, player_id2);
-    list_t *body1_pts = body_get_shape(body1);
-    list_t *body2_pts = body_get_shape(body2);
-    if (find_collision(body1_pts, body2_pts).collided && p1->cd_collide_player <= 0 && p2->cd_collide_player <= 0)
-    {
-      vector_t head_velocity = body_get_velocity(body1);
-      vector_t body_velocity = body_get_velocity(body2);
-
-      vector_t impulse_on_head = vec_multiply(PLAYER_COLLISION_IMPULSE, vec_perpendicular(body_velocity));
-      if (fabs(vec_angle(impulse_on_head, head_velocity)) < M_PI / 2)
-      {
-        impulse_on_head = vec_multiply(-1, impulse_on_head);
-      }
-      vector_t impulse_on_body = vec_multiply(PLAYER_COLLISION_IMPULSE, head_velocity);
-
-      body_add_impulse(body1, impulse_on_head);
-      body_add_impulse(body2, impulse_on_body);
-      player_refresh_cd_collide_player(p1);
-      player_refresh_cd_collide_player(p2);
-      sdl_play_sound(FREE_CHANNEL, "assets/collide.wav", 0);
-    }
-    list_free(body1_pts);
-    list_free(body2_pts);
-  }
-}
-
-void bullet_collision_handler(body_t *body1, body_t *body2, vector_t axis,
-                              void *aux)
-{
-  state_t *state = (state_t *)aux;
-  size_t bullet_player_id = *((size_t *)list_get((list_t *)body_get_info(body1), 1));
-  char *body_impacted_type = list_get((list_t *)body_get_info(body2), 0);
-  list_t *bullet_pts = body_get_shape(body1);
-  list_t *impact_pts = body_get_shape(body2);
-
-  if (find_collision(bullet_pts, impact_pts).collided)
-  {
-    if (strcmp(body_impacted_type, "wall_top") == 0 || strcmp(body_impacted_type, "wall_bottom") == 0 ||
-        strcmp(body_impacted_type, "wall_left") == 0 || strcmp(body_impacted_type, "wall_right") == 0)
-    {
-      body_remove(body1);
-    }
-    else // if bullet hits a player
-    {
-      player_t *player_who_shot_bullet = list_get(state->players, bullet_player_id);
-      size_t player_hit_id = *((size_t *)list_get((list_t *)body_get_info(body2), 1)); // hits player
-      player_t *player_to_remove = list_get(state->players, player_hit_id);
-      player_hit(player_who_shot_bullet, player_to_remove, body2, state->scene_game);
-      body_remove(body1);
-    }
-  }
-  list_free(bullet_pts);
-  list_free(impact_pts);
-}
-
-void pellet_collision_handler(body_t *body1, body_t *body2, vector_t axis,
-                              void *aux)
-{
-  list_t *aux_casted = (list_t *)aux;
-  state_t *state = list_get(aux_casted, 0);
-  player_t *player = list_get(aux_casted, 1);
-  list_t *snake_pts = body_get_shape(body1);
-  list_t *food_pts = body_get_shape(body2);
-
-  if (find_collision(snake_pts, food_pts).collided)
-  {
-    player_eat(player, body2, state->scene_game);
-    body_t *added_body = player_add_body(player);
-    scene_add_body(state->scene_game, added_body);
-    create_drag(state->scene_game, DRAG_CONST, list_get(player->meta_bodies, list_size(player->meta_bodies) - 1));
-    create_spring(state->scene_game, SPRING_CONST, list_get(player->meta_bodies, list_size(player->meta_bodies) - 1), list_get(player->meta_bodies, list_size(player->meta_bodies) - 2));
-    for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
-    { // add collisions between added body and other player heads
-      if (list_get(state->players, i) != player)
-      {
-        body_t *player_head = player_get_head(list_get(state->players, i));
-        create_collision(state->scene_game, player_head, added_body, player_collision_handler, state, NULL);
-      }
-    }
-    for (size_t i = 0; i < scene_bodies(state->scene_game); i++) // add collisions between added body and existing bullets
-    {
-      body_t *curr_body = scene_get_body(state->scene_game, i);
-      char *body_type = list_get((list_t *)body_get_info(curr_body), 0);
-      if (strcmp(body_type, "bullet") == 0) // if its a bullet
-      {
-        size_t curr_body_player_id = *((size_t *)list_get((list_t *)body_get_info(curr_body), 1));
-        if (curr_body_player_id != player->player_id)
-        {
-          create_collision(state->scene_game, curr_body, added_body, bullet_collision_handler, state, NULL);
-        }
-      }
-    }
-    body_remove(body2);
-  }
-  list_free(snake_pts);
-  list_free(food_pts);
-}
-
-list_t *get_pu_types()
-{
-  list_t *pu_types = list_init(4, free);
-  list_add(pu_types, "pu_base_speed");
-  list_add(pu_types, "pu_bullet_speed");
-  list_add(pu_types, "pu_rotate_rate");
-  list_add(pu_types, "pu_dash_boost");
-  return pu_types;
-}
-
-list_t *get_pu_colors()
-{
-  list_t *pu_colors = list_init(4, free);
-  color_t *color1 = malloc(sizeof(color_t));
-  color_t *color2 = malloc(sizeof(color_t));
-  color_t *color3 = malloc(sizeof(color_t));
-  color_t *color4 = malloc(sizeof(color_t));
-  *color1 = (color_t){.r = 0.3, .b = 1, .g = 1, .a = 1};
-  *color2 = (color_t){.r = 0.5, .b = 1, .g = 0.1, .a = 1};
-  *color3 = (color_t){.r = 1, .b = 0.9, .g = 0, .a = 1};
-  *color4 = (color_t){.r = 1, .b = 0, .g = 0.9, .a = 1};
-  list_add(pu_colors, color1);
-  list_add(pu_colors, color2);
-  list_add(pu_colors, color3);
-  list_add(pu_colors, color4);
-  return pu_colors;
-}
-
-void spawn_pellet(state_t *state, list_t *pu_types, list_t *pu_colors)
-{
-  vector_t pellet_pos = (vector_t){.x = (double)rand_range(MIN_POSITION.x, WINDOW.x), .y = (double)rand_range(MIN_POSITION.y, WINDOW.y)};
-  size_t pellet_type = (size_t)(rand_range(0, 1) * 4);
-  list_t *info = list_init(2, free);
-  char *body_type = malloc(sizeof(char) * INFO_MAX_LEN);
-  char *pu_type = malloc(sizeof(char) * INFO_MAX_LEN);
-  strcpy(body_type, "food\0");
-  strcpy(pu_type, (char *)list_get(pu_types, pellet_type));
-  list_add(info, body_type);
-  list_add(info, pu_type);
-  body_t *food = body_init_with_info(make_circle(6, FOOD_SIDE_LENGTH, pellet_pos), 1, *((color_t *)list_get(pu_colors, pellet_type)), info, list_free);
-  body_set_glow(food, true);
-  body_set_glow_radius(food, FOOD_SIDE_LENGTH);
-  scene_add_body(state->scene_game, food);
-  for (size_t k = 0; k < GAME_NUM_PLAYERS; k++)
-  {
-    list_t *aux = list_init(2, NULL);
-    list_add(aux, state);
-    list_add(aux, list_get(state->players, k));
-    create_collision(state->scene_game, player_get_head(list_get(state->players, k)), food, pellet_collision_handler, aux, NULL);
-  }
-}
-
-void spawn_color_choices(state_t *state, size_t *player_id, vector_t center, color_t c1, color_t c2, color_t c3, color_t c4)
+void spawn_color_choices(state_t *state, size_t player_id, vector_t center, const color_t *choices)
 {
   vector_t choice1_pos = vec_add(center, (vector_t){-30, 30});
   vector_t choice2_pos = vec_add(center, (vector_t){30, 30});
   vector_t choice3_pos = vec_add(center, (vector_t){-30, -30});
   vector_t choice4_pos = vec_add(center, (vector_t){30, -30});
 
-  body_t *choice1 = body_init_with_info(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice1_pos), CHOICE_MASS, c1, player_id, free);
-  body_t *choice2 = body_init_with_info(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice2_pos), CHOICE_MASS, c2, player_id, free);
-  body_t *choice3 = body_init_with_info(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice3_pos), CHOICE_MASS, c3, player_id, free);
-  body_t *choice4 = body_init_with_info(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice4_pos), CHOICE_MASS, c4, player_id, free);
+  body_t *choice1 = body_init(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice1_pos), CHOICE_MASS, choices[0]);
+  body_t *choice2 = body_init(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice2_pos), CHOICE_MASS, choices[1]);
+  body_t *choice3 = body_init(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice3_pos), CHOICE_MASS, choices[2]);
+  body_t *choice4 = body_init(make_rectangle(CHOICE_SIZE, CHOICE_SIZE, choice4_pos), CHOICE_MASS, choices[3]);
+  body_tag_t tag = {.category = CATEGORY_CHOICE, .owner = player_id};
+  body_set_tag(choice1, tag);
+  body_set_tag(choice2, tag);
+  body_set_tag(choice3, tag);
+  body_set_tag(choice4, tag);
 
   scene_add_body(state->scene_menu, choice1);
   scene_add_body(state->scene_menu, choice2);
@@ -364,135 +144,29 @@ void spawn_color_choices(state_t *state, size_t *player_id, vector_t center, col
 
 void game_init(state_t *state)
 {
-  state->scene_game = scene_init();
   state->game_started = true;
 
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
+  // the bots join the players at the keyboard, numbered after them
+  for (size_t i = 0; i < state->num_bots; i++)
   {
-    player_t *player = list_get(state->players, i);
-    for (size_t j = 0; j < list_size(player->meta_bodies); j++)
-    {
-      body_t *meta_body = (body_t *)list_get(player->meta_bodies, j);
-      scene_add_body(state->scene_game, meta_body);
-      if (j == 0)
-      {
-        *player->ph_applied_force_magnitude = DRAG_CONST * vec_norm(body_get_velocity(player_get_head(player)));
-        create_applied_force(state->scene_game, player->ph_applied_force_magnitude, player_get_head(player));
-        create_drag(state->scene_game, DRAG_CONST, player_get_head(player));
-      }
-      else
-      {
-        create_drag(state->scene_game, DRAG_CONST, list_get(player->meta_bodies, j));
-        create_spring(state->scene_game, SPRING_CONST, meta_body, list_get(player->meta_bodies, j - 1));
-      }
-    }
-  }
-
-  // adds collisions between players:
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
-  {
-    for (size_t j = 0; j < GAME_NUM_PLAYERS; j++)
-    {
-      if (i != j)
-      {
-        body_t *player1_head = player_get_head(list_get(state->players, i));
-        player_t *player2 = (player_t *)list_get(state->players, j);
-
-        for (size_t k = 1; k < list_size(player2->meta_bodies); k++)
-        {
-          body_t *player2_metabody = list_get(player2->meta_bodies, k);
-          create_collision(state->scene_game, player1_head, player2_metabody, player_collision_handler, state, NULL);
-        }
-      }
-    }
-  }
-
-  // "respawn" (aka init) players
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
-  {
-    player_t *player = list_get(state->players, i);
-    player_respawn(player, state->scene_game);
+    arena_add_bot(state->arena);
   }
 
   // spawn random food
-  list_t *pu_types = get_pu_types();
-  list_t *pu_colors = get_pu_colors();
-
   for (size_t i = 0; i < FOOD_COUNT_INITIAL; i++)
   {
-    spawn_pellet(state, pu_types, pu_colors);
-  }
-
-  // initialize walls
-  list_t *wall_left_pts = make_left_wall();
-  list_t *wall_left_info = list_init(1, free);
-  char *wall_left_name = malloc(sizeof(char) * INFO_MAX_LEN);
-  wall_left_name = "wall_left";
-  list_add(wall_left_info, wall_left_name);
-
-  list_t *wall_top_pts = make_top_wall();
-  list_t *wall_top_info = list_init(1, free);
-  char *wall_top_name = malloc(sizeof(char) * INFO_MAX_LEN);
-  wall_top_name = "wall_top";
-  list_add(wall_top_info, wall_top_name);
-
-  list_t *wall_right_pts = make_right_wall();
-  list_t *wall_right_info = list_init(1, free);
-  char *wall_right_name = malloc(sizeof(char) * INFO_MAX_LEN);
-  wall_right_name = "wall_right";
-  list_add(wall_right_info, wall_right_name);
-
-  list_t *wall_bottom_pts = make_bottom_wall();
-  list_t *wall_bottom_info = list_init(1, free);
-  char *wall_bottom_name = malloc(sizeof(char) * INFO_MAX_LEN);
-  wall_bottom_name = "wall_bottom";
-  list_add(wall_bottom_info, wall_bottom_name);
-
-  body_t *wall_left = body_init_with_info(wall_left_pts, WALL_MASS, WALL_COLOR, wall_left_info, NULL);
-  body_t *wall_top = body_init_with_info(wall_top_pts, WALL_MASS, WALL_COLOR, wall_top_info, NULL);
-  body_t *wall_right = body_init_with_info(wall_right_pts, WALL_MASS, WALL_COLOR, wall_right_info, NULL);
-  body_t *wall_bottom = body_init_with_info(wall_bottom_pts, WALL_MASS, WALL_COLOR, wall_bottom_info, NULL);
-
-  scene_add_body(state->scene_game, wall_left);
-  scene_add_body(state->scene_game, wall_top);
-  scene_add_body(state->scene_game, wall_right);
-  scene_add_body(state->scene_game, wall_bottom);
-
-  for (size_t k = 0; k < GAME_NUM_PLAYERS; k++)
-  {
-    create_collision(state->scene_game, player_get_head(list_get(state->players, k)), wall_top, wall_collision_handler, NULL, NULL);
-    create_collision(state->scene_game, player_get_head(list_get(state->players, k)), wall_bottom, wall_collision_handler, NULL, NULL);
-    create_collision(state->scene_game, player_get_head(list_get(state->players, k)), wall_left, wall_collision_handler, NULL, NULL);
-    create_collision(state->scene_game, player_get_head(list_get(state->players, k)), wall_right, wall_collision_handler, NULL, NULL);
+    arena_spawn_pellet(state->arena);
   }
 
-  // show player tags
-  for (size_t player_id = 0; player_id < list_size(state->players); player_id++)
+  // summon player keybind titles
+  for (size_t i = 0; i < GAME_NUM_HUMANS; i++)
   {
-    player_t *p = (player_t *)list_get(state->players, player_id);
-    scene_add_text(state->scene_game, p->score_tag);
+    char *help_text = malloc(sizeof(char) * INFO_MAX_LEN);
+    strcpy(help_text, PLAYER_HELP_TEXTS[i]);
+    color_t help_color = ((player_t *)list_get(arena_get_players(state->arena), i))->st_color;
+    help_color.a = HELP_OPACITY;
+    scene_add_text(arena_get_scene(state->arena), text_init(help_text, PLAYER_SETTINGS_CENTERS[i], HELP_HEIGHT, HELP_WIDTH, help_color, INFINITY));
   }
-
-  // summon player keybind titles
-  char player1_help_text[INFO_MAX_LEN] = "Q W E R";
-  char player2_help_text[INFO_MAX_LEN] = "U I O P";
-  char player3_help_text[INFO_MAX_LEN] = "Z X C V";
-  char player4_help_text[INFO_MAX_LEN] = "B N M <";
-
-  color_t player1_color = ((player_t *) list_get(state->players, 0))->st_color;
-  color_t player2_color = ((player_t *) list_get(state->players, 1))->st_color;
-  color_t player3_color = ((player_t *) list_get(state->players, 2))->st_color;
-  color_t player4_color = ((player_t *) list_get(state->players, 3))->st_color;
-
-  player1_color.r = HELP_OPACITY;
-  player2_color.g = HELP_OPACITY;
-  player3_color.b = HELP_OPACITY;
-  player4_color.a = HELP_OPACITY;
-
-  scene_add_text(state->scene_game, text_init(player1_help_text, PLAYER_1_SETTINGS_CENTER, HELP_HEIGHT, HELP_WIDTH, player1_color, INFINITY));
-  scene_add_text(state->scene_game, text_init(player2_help_text, PLAYER_2_SETTINGS_CENTER, HELP_HEIGHT, HELP_WIDTH, player2_color, INFINITY));
-  scene_add_text(state->scene_game, text_init(player3_help_text, PLAYER_3_SETTINGS_CENTER, HELP_HEIGHT, HELP_WIDTH, player3_color, INFINITY));
-  scene_add_text(state->scene_game, text_init(player4_help_text, PLAYER_4_SETTINGS_CENTER, HELP_HEIGHT, HELP_WIDTH, player4_color, INFINITY));
 }
 
 void menu_init(state_t *state)
@@ -502,13 +176,16 @@ void menu_init(state_t *state)
   state->game_started = false;
   state->sound_playing = false;
   state->game_time = 0;
+  state->num_bots = GAME_NUM_BOTS_DEFAULT;
 
-  // spawn players
-  state->players = list_init(GAME_NUM_PLAYERS, player_free);
-  list_add(state->players, player_init(0, COLOR_BLACK, CENTER, 'q', 'e', 'w', 'r'));
-  list_add(state->players, player_init(1, COLOR_BLACK, CENTER, 'u', 'o', 'i', 'p'));
-  list_add(state->players, player_init(2, COLOR_BLACK, CENTER, 'z', 'c', 'x', 'v'));
-  list_add(state->players, player_init(3, COLOR_BLACK, CENTER, 'b', 'm', 'n', ','));
+  // spawn players; the game doesn't tick until it starts, so they wait
+  // in the arena while their colors are chosen
+  state->arena = arena_init(MIN_POSITION, WINDOW);
+  for (size_t i = 0; i < GAME_NUM_HUMANS; i++)
+  {
+    const char *keys = PLAYER_KEYS[i];
+    arena_add_player(state->arena, player_init(i, COLOR_BLACK, CENTER, keys[0], keys[1], keys[2], keys[3]));
+  }
 
   // title
   char *title_text = malloc(sizeof(char) * INFO_MAX_LEN);
@@ -530,50 +207,30 @@ void menu_init(state_t *state)
   strcpy(help_text, "Hover to Select Color");
   text_t *help = text_init(help_text, help_pos, HELP_HEIGHT, HELP_WIDTH, HELP_COLOR, INFINITY);
 
-  // player titles
-  char *player1_title_text = malloc(sizeof(char) * INFO_MAX_LEN);
-  char *player2_title_text = malloc(sizeof(char) * INFO_MAX_LEN);
-  char *player3_title_text = malloc(sizeof(char) * INFO_MAX_LEN);
-  char *player4_title_text = malloc(sizeof(char) * INFO_MAX_LEN);
-  strcpy(player1_title_text, "Player 1");
-  strcpy(player2_title_text, "Player 2");
-  strcpy(player3_title_text, "Player 3");
-  strcpy(player4_title_text, "Player 4");
-
-  vector_t player1_title_pos = vec_add(PLAYER_1_SETTINGS_CENTER, (vector_t){0, 100});
-  vector_t player2_title_pos = vec_add(PLAYER_2_SETTINGS_CENTER, (vector_t){0, 100});
-  vector_t player3_title_pos = vec_add(PLAYER_3_SETTINGS_CENTER, (vector_t){0, 100});
-  vector_t player4_title_pos = vec_add(PLAYER_4_SETTINGS_CENTER, (vector_t){0, 100});
-
+  // player titles, first among the texts so a player's id indexes its title
   color_t player_title_color = (color_t){.r = 1, .g = 1, .b = 1, .a = 0.8};
+  for (size_t i = 0; i < GAME_NUM_HUMANS; i++)
+  {
+    char *player_title_text = malloc(sizeof(char) * INFO_MAX_LEN);
+    snprintf(player_title_text, INFO_MAX_LEN, "Player %zu", i + 1);
+    vector_t player_title_pos = vec_add(PLAYER_SETTINGS_CENTERS[i], (vector_t){0, 100});
+    text_t *player_title = text_init(player_title_text, player_title_pos, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, player_title_color, INFINITY);
+    scene_add_text(state->scene_menu, player_title);
+    spawn_color_choices(state, i, vec_add(player_title_pos, CHOICE_SPAWN_POSITION), PLAYER_COLOR_CHOICES[i]);
+  }
 
-  text_t *player1_title = text_init(player1_title_text, player1_title_pos, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, player_title_color, INFINITY);
-  text_t *player2_title = text_init(player2_title_text, player2_title_pos, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, player_title_color, INFINITY);
-  text_t *player3_title = text_init(player3_title_text, player3_title_pos, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, player_title_color, INFINITY);
-  text_t *player4_title = text_init(player4_title_text, player4_title_pos, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, player_title_color, INFINITY);
+  // bots setting
+  char *bots_help_text = malloc(sizeof(char) * INFO_MAX_LEN);
+  strcpy(bots_help_text, "Up/Down to Choose Bots");
+  text_t *bots_help = text_init(bots_help_text, vec_add(BOTS_SETTING_CENTER, (vector_t){0, 50}), HELP_HEIGHT, HELP_WIDTH, HELP_COLOR, INFINITY);
+  state->num_bots_tag = text_init_number(state->num_bots, BOTS_SETTING_CENTER, PLAYER_TEXT_HEIGHT, PLAYER_TEXT_WIDTH, COLOR_WHITE, INFINITY);
 
   // add all texts
-  scene_add_text(state->scene_menu, player1_title);
-  scene_add_text(state->scene_menu, player2_title);
-  scene_add_text(state->scene_menu, player3_title);
-  scene_add_text(state->scene_menu, player4_title);
   scene_add_text(state->scene_menu, title);
   scene_add_text(state->scene_menu, start_button);
   scene_add_text(state->scene_menu, help);
-
-  size_t *p1_id = malloc(sizeof(size_t));
-  size_t *p2_id = malloc(sizeof(size_t));
-  size_t *p3_id = malloc(sizeof(size_t));
-  size_t *p4_id = malloc(sizeof(size_t));
-  *p1_id = 0;
-  *p2_id = 1;
-  *p3_id = 2;
-  *p4_id = 3;
-
-  spawn_color_choices(state, p1_id, vec_add(player1_title_pos, CHOICE_SPAWN_POSITION), COLOR_PLAYER1_CHOICE1, COLOR_PLAYER1_CHOICE2, COLOR_PLAYER1_CHOICE3, COLOR_PLAYER1_CHOICE4);
-  spawn_color_choices(state, p2_id, vec_add(player2_title_pos, CHOICE_SPAWN_POSITION), COLOR_PLAYER2_CHOICE1, COLOR_PLAYER2_CHOICE2, COLOR_PLAYER2_CHOICE3, COLOR_PLAYER2_CHOICE4);
-  spawn_color_choices(state, p3_id, vec_add(player3_title_pos, CHOICE_SPAWN_POSITION), COLOR_PLAYER3_CHOICE1, COLOR_PLAYER3_CHOICE2, COLOR_PLAYER3_CHOICE3, COLOR_PLAYER3_CHOICE4);
-  spawn_color_choices(state, p4_id, vec_add(player4_title_pos, CHOICE_SPAWN_POSITION), COLOR_PLAYER4_CHOICE1, COLOR_PLAYER4_CHOICE2, COLOR_PLAYER4_CHOICE3, COLOR_PLAYER4_CHOICE4);
+  scene_add_text(state->scene_menu, bots_help);
+  scene_add_text(state->scene_menu, state->num_bots_tag);
 }
 
 void keyboard_handler(state_t *state, char key, key_event_type_t type, double held_time)
@@ -586,10 +243,11 @@ void keyboard_handler(state_t *state, char key, key_event_type_t type, double he
 
   if (state->game_started)
   {
+    // only the players at the keyboard have keys; the rest are bots
     player_t *p = NULL;
-    for (size_t player_id = 0; player_id < GAME_NUM_PLAYERS; player_id++)
+    for (size_t player_id = 0; player_id < GAME_NUM_HUMANS; player_id++)
     {
-      player_t *curr_p = list_get(state->players, player_id);
+      player_t *curr_p = list_get(arena_get_players(state->arena), player_id);
       if (player_moves_on_key(curr_p, key))
       {
         p = curr_p;
@@ -630,38 +288,34 @@ void keyboard_handler(state_t *state, char key, key_event_type_t type, double he
     }
     else if (type == 0 && p->st_shoot_key == key && p->cd_shoot == 0)
     {
-      body_t *bullet = player_shoot(p);
-      for (size_t i = 0; i < scene_bodies(state->scene_game); i++) // create bullet collision with walls
+      player_shoot(p);
+    }
+  }
+  else
+  {
+    // the arrows choose how many bots to play against instead of starting
+    if (key == UP_ARROW || key == DOWN_ARROW)
+    {
+      if (type == KEY_PRESSED)
       {
-        list_t *body_info = (list_t *)body_get_info(scene_get_body(state->scene_game, i));
-        char *body_type = list_get(body_info, 0);
-
-        if (strcmp(body_type, "wall_top") == 0 || strcmp(body_type, "wall_bottom") == 0 || strcmp(body_type, "wall_left") == 0 || strcmp(body_type, "wall_right") == 0)
+        if (key == UP_ARROW && state->num_bots < GAME_MAX_BOTS)
         {
-          create_collision(state->scene_game, bullet, scene_get_body(state->scene_game, i), bullet_collision_handler, state, NULL);
+          state->num_bots++;
         }
-      }
-      for (size_t i = 0; i < list_size(state->players); i++) // create bullet collisions with player bodies
-      {
-        player_t *player = list_get(state->players, i);
-        if (p != player)
+        else if (key == DOWN_ARROW && state->num_bots > 0)
         {
-          list_t *mb = player->meta_bodies;
-          for (size_t j = 0; j < list_size(mb); j++)
-          {
-            body_t *b = list_get(mb, j);
-            create_collision(state->scene_game, bullet, b, bullet_collision_handler, state, NULL);
-          }
+          state->num_bots--;
         }
+        text_set_number(state->num_bots_tag, state->num_bots);
+        sdl_play_sound(FREE_CHANNEL, "assets/menu_select.wav", 0);
       }
-      scene_add_body(state->scene_game, bullet);
+      return;
     }
-  }
-  else
-  {
-    for (size_t i = 0; i < list_size(state->players); i++)
+
+    list_t *players = arena_get_players(state->arena);
+    for (size_t i = 0; i < list_size(players); i++)
     {
-      player_t *p = (player_t *)list_get(state->players, i);
+      player_t *p = (player_t *)list_get(players, i);
       if (color_equals(p->st_color, (color_t){0, 0, 0, 1}))
       {
         char *error_text = malloc(sizeof(char) * INFO_MAX_LEN);
@@ -682,18 +336,21 @@ state_t *emscripten_init()
 {
   // init sdl
   sdl_init(MIN_POSITION, WINDOW);
+  sdl_load_sounds(SOUND_PATHS, sizeof(SOUND_PATHS) / sizeof(SOUND_PATHS[0]));
+  powerups_load_sounds();
 
   // init state
   state_t *state = malloc(sizeof(state_t));
+  state->background = sdl_load_texture(BACKGROUND_PATH);
+  state->snapshot = snapshot_init();
 
   menu_init(state);
 
   return state;
 }
 
-void handle_mouse(state_t *state)
+void handle_mouse(state_t *state, vector_t mouse_pos)
 {
-  vector_t mouse_pos = get_mouse_pos();
   // body hovering
   if (!state->game_started)
   {
@@ -708,8 +365,8 @@ void handle_mouse(state_t *state)
       {
         if (mouse_pos.y > corrected_y - (CHOICE_SIZE / 2) && mouse_pos.y < corrected_y + (CHOICE_SIZE / 2))
         {
-          size_t p_id = *((size_t *)body_get_info(b));
-          player_t *p = ((player_t *)list_get(state->players, p_id));
+          size_t p_id = body_get_tag(b).owner;
+          player_t *p = ((player_t *)list_get(arena_get_players(state->arena), p_id));
           text_t *t = list_get(scene_get_texts(state->scene_menu), p_id);
           color_t color = body_get_color(b);
           if (!color_equals(p->st_color, color))
@@ -724,80 +381,49 @@ void handle_mouse(state_t *state)
   }
 }
 
-void main_spawn_pellets(state_t *state)
+void main_tick_menu(state_t *state)
 {
-  // random powerup spawns
-  list_t *pu_types = get_pu_types();
-  list_t *pu_colors = get_pu_colors();
-
-  if (state->time_since_pellet_spawn >= FOOD_SPAWN_TIME) // spawn pellets
-  {
-    state->time_since_pellet_spawn = 0;
-    spawn_pellet(state, pu_types, pu_colors);
-  }
-}
-
-void main_tick_players(state_t *state)
-{
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
+  // tick text buttons
+  for (size_t i = 0; i < list_size(scene_get_texts(state->scene_menu)); i++)
   {
-    player_t *p = list_get(state->players, i);
-    if (player_dying(p))
+    text_t *t = list_get(scene_get_texts(state->scene_menu), i);
+    if (!t->removed)
     {
-      player_tick_death(p, state->scene_game);
+      text_tick(t, dt);
     }
-    player_tick(p, dt);
-    player_turn(p);
   }
-  scene_tick_canon(state->scene_game, dt);
 }
 
-void main_render_game(state_t *state)
+void main_render_game(state_t *state, snapshot_t *snapshot)
 {
-  // shows cosmetics that are below the bodies in the scene
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
-  {
-    player_t *p = list_get(state->players, i);
-    player_render_cosmetics_below(p);
-  }
+  // glows and texts are below the bodies in the scene
+  scene_t *scene = arena_get_scene(state->arena);
+  snapshot_add_glows(snapshot, scene);
+  snapshot_add_texts(snapshot, scene);
 
   // draws all the bodies in a scene
-  sdl_render_scene(state->scene_game);
-  // scene_draw(state->scene_game);
+  snapshot_add_bodies(snapshot, scene);
 
   // shows cosmetics that are above the bodies in the scene
-  for (size_t i = 0; i < GAME_NUM_PLAYERS; i++)
+  list_t *players = arena_get_players(state->arena);
+  for (size_t i = 0; i < list_size(players); i++)
   {
-    player_t *p = list_get(state->players, i);
-    player_render_cosmetics_above(p);
+    player_t *p = list_get(players, i);
+    player_render_cosmetics_above(p, snapshot);
   }
 }
 
-void main_render_menu(state_t *state)
+void main_render_menu(state_t *state, snapshot_t *snapshot)
 {
-  // tick bodies
-  sdl_render_scene(state->scene_menu);
-
-  // tick text buttons
-  for (size_t i = 0; i < list_size(scene_get_texts(state->scene_menu)); i++)
-  {
-    text_t *t = list_get(scene_get_texts(state->scene_menu), i);
-    if (!t->removed)
-    {
-      text_tick(t, dt);
-    }
-  }
+  snapshot_add_background(snapshot, state->background);
+  snapshot_add_bodies(snapshot, state->scene_menu);
+  snapshot_add_texts(snapshot, state->scene_menu);
 }
 
-void emscripten_main(state_t *state)
+void emscripten_tick(state_t *state, vector_t mouse)
 {
-  // sdl: clear window
-  sdl_clear();
-
   // handle mouse
-  handle_mouse(state);
-
-  // sdl_render_image();
+  handle_mouse(state, mouse);
 
   // handle keypresses
   sdl_on_key(keyboard_handler);
@@ -805,25 +431,59 @@ void emscripten_main(state_t *state)
   if (state->game_started)
   {
     state->game_time += dt;
-    state->time_since_pellet_spawn += dt;
-    main_spawn_pellets(state);
-    main_tick_players(state);
-    main_render_game(state);
+    arena_tick(state->arena, dt);
   }
   else
   {
-    sdl_render_image();
-    main_render_menu(state);
+    main_tick_menu(state);
   }
+}
+
+double emscripten_tick_length(void)
+{
+  return dt;
+}
+
+void emscripten_snapshot(state_t *state, snapshot_t *snapshot)
+{
+  if (state->game_started)
+  {
+    main_render_game(state, snapshot);
+  }
+  else
+  {
+    main_render_menu(state, snapshot);
+  }
+}
+
+bool emscripten_is_static(state_t *state)
+{
+  return !state->game_started;
+}
+
+void emscripten_main(state_t *state)
+{
+  emscripten_tick(state, get_mouse_pos());
+
+  // sdl: start a frame, only redrawing what changed on the menu
+  sdl_set_dirty_rendering(emscripten_is_static(state));
+  sdl_begin_frame();
+  snapshot_clear(state->snapshot, state->game_time);
+  emscripten_snapshot(state, state->snapshot);
+  snapshot_draw(NULL, state->snapshot, 1);
 
-  // sdl: show
-  sdl_show();
+  // sdl: draw and show the frame
+  sdl_end_frame();
 }
 
 // emscripten: free resources
 void emscripten_free(state_t *state)
 {
-  scene_free(state->scene_game);
+  arena_free(state->arena);
   scene_free(state->scene_menu);
+  sdl_free_sounds();
+  sdl_free_textures();
+  snapshot_free(state->snapshot);
+  prototype_free_all();
   free(state);
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include "list.h"
+#include "player.h"
+#include "scene.h"
+#include "vector.h"
+
+/**
+ * The rules of slyce: a walled arena where slugs eat pellets to grow,
+ * bump each other around and shoot each other's segments off.
+ * The arena owns the game's scene, its players and the bots playing some of
+ * them, and ticks them all, so the game and the benchmarks play exactly
+ * the same rules.
+ */
+typedef struct arena arena_t;
+
+/**
+ * Allocates an empty arena with walls around it.
+ *
+ * @param min the bottom left corner of the area inside the walls
+ * @param max the top right corner of the area inside the walls
+ * @return the new arena
+ */
+arena_t *arena_init(vector_t min, vector_t max);
+
+/**
+ * Releases an arena, its scene, its players and its bots.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_free(arena_t *arena);
+
+/**
+ * Gets the scene the game is played in, e.g. to draw it or add texts to it.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @return the arena's scene
+ */
+scene_t *arena_get_scene(arena_t *arena);
+
+/**
+ * Gets the players in the arena, indexed by their ids.
+ * The list belongs to the arena.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @return the list of players
+ */
+list_t *arena_get_players(arena_t *arena);
+
+/**
+ * Adds a player to the arena and respawns it somewhere in it.
+ * The arena takes ownership of the player.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @param player a player whose id is the number of players already added
+ */
+void arena_add_player(arena_t *arena, player_t *player);
+
+/**
+ * Adds a player of a random color, played by a bot (see bot.h).
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_add_bot(arena_t *arena);
+
+/**
+ * Spawns a pellet of a random powerup somewhere in the arena.
+ * Gives up if it can't find a free spot after a few tries.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_spawn_pellet(arena_t *arena);
+
+/**
+ * Plays one tick of the game: spawns pellets every so often,
+ * lets the bots and players move, ticks the scene and lets each head eat
+ * the pellets it touches.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @param dt the time elapsed since the last tick, in seconds
+ */
+void arena_tick(arena_t *arena, double dt);
+
+#endif // #ifndef __ARENA_H__
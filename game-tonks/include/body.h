@@ -3,17 +3,58 @@
 
 #include "color.h"
 #include "list.h"
+#include "prototype.h"
 #include "vector.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * A rigid body constrained to the plane.
  * Implemented as a polygon with uniform density.
- * Bodies can accumulate forces and impulses during each tick.
- * Angular physics (i.e. torques) are not currently implemented.
+ * Bodies can accumulate forces, torques and impulses during each tick.
+ * Bodies are created with infinite inertia: they never rotate, and skip the
+ * rotational update entirely, until body_enable_rotation() gives them
+ * the moment of inertia of their shape.
+ * Bodies that stay at rest can be put to sleep by the scene; sleeping bodies
+ * are not integrated, and wake up when a nonzero force, torque, impulse or
+ * velocity is applied to them.
  */
 typedef struct body body_t;
 
+/**
+ * An axis-aligned box, e.g. around a body's shape.
+ */
+typedef struct {
+  vector_t min; // the bottom left corner
+  vector_t max; // the top right corner
+} bounds_t;
+
+/**
+ * A typed label saying what a body is, so collision handlers and other code
+ * can tell bodies apart with integer comparisons instead of parsing their info.
+ * The engine never interprets tags; games define their own categories.
+ * Each category is a single bit, so a set of categories is a mask
+ * that a body can be tested against (see body_in_categories()).
+ * Bodies start with a zero tag, whose category is in no mask.
+ */
+typedef struct {
+  uint32_t category; // a single bit chosen by the game, or 0
+  size_t owner;      // e.g. the id of the player the body belongs to
+  size_t subtype;    // e.g. which side a wall is on
+} body_tag_t;
+
+/**
+ * A reference to a body in a scene that can tell when the body is gone:
+ * the index of the scene's slot holding the body, and the slot's generation,
+ * which changes whenever the body in the slot is freed.
+ * Generations start at 1, so a zeroed handle never refers to a body.
+ * See scene_get_body_handle().
+ */
+typedef struct {
+  uint32_t index;
+  uint32_t generation;
+} body_handle_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
@@ -37,6 +78,29 @@ body_t *body_init_with_info(list_t *shape, double mass, color_t color,
                             void *info, free_func_t info_freer);
 
 /**
+ * Allocates memory for a body whose shape is a shared prototype,
+ * placed with its centroid at a given point. The body only stores
+ * where the prototype is and how it is rotated, so creating, moving and
+ * rotating it never touches the prototype's vertices;
+ * body_get_shape() builds them when they are needed.
+ *
+ * @param prototype a prototype, e.g. from prototype_get_round()
+ * @param centroid the initial centroid of the body
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @param info additional information to associate with the body
+ * @param info_freer if non-NULL, a function call on the info to free it
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_with_prototype(prototype_t *prototype, vector_t centroid,
+                                 double mass, color_t color, void *info,
+                                 free_func_t info_freer);
+
+/**
+ * Applies the impulses of an elastic collision to two colliding bodies.
+ * If either body can rotate, the impulse is applied at the point where
+ * the bodies touch, so off-center hits make them spin.
+ *
  * @param body1 First body in collision
  * @param body2 Second body in collision
  * @param elasticity Coefficient of restitution
@@ -50,6 +114,15 @@ void body_add_elastic_impulse(body_t *body1, body_t *body2, double elasticity);
  */
 void body_free(void *body);
 
+/**
+ * Gets the prototype a body's shape comes from.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the prototype passed to body_init_with_prototype(),
+ *   or NULL if the body has its own shape
+ */
+prototype_t *body_get_prototype(body_t *body);
+
 /**
  * Gets the current shape of a body.
  * Returns a newly allocated vector list, which must be list_free()d.
@@ -59,6 +132,15 @@ void body_free(void *body);
  */
 list_t *body_get_shape(body_t *body);
 
+/**
+ * Gets a box around a body's current shape, without going through
+ * its vertices. The box is kept up to date as the body moves and rotates.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the box around the body
+ */
+bounds_t body_get_bounds(body_t *body);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -110,6 +192,39 @@ color_t body_get_color(body_t *body);
  */
 void *body_get_info(body_t *body);
 
+/**
+ * Gets the tag of a body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the tag set with body_set_tag(), or a zero tag
+ */
+body_tag_t body_get_tag(body_t *body);
+
+/**
+ * Sets the tag of a body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param tag what the body is
+ */
+void body_set_tag(body_t *body, body_tag_t tag);
+
+/**
+ * Gets the category of a body's tag.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the category bit, or 0 if the body isn't tagged
+ */
+uint32_t body_get_category(body_t *body);
+
+/**
+ * Returns whether a body's category is in a set of categories.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param categories a mask of category bits
+ * @return whether the body's category bit is set in the mask
+ */
+bool body_in_categories(body_t *body, uint32_t categories);
+
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
@@ -119,6 +234,17 @@ void *body_get_info(body_t *body);
  */
 void body_set_centroid(body_t *body, vector_t x);
 
+/**
+ * Moves a body by a given displacement.
+ * Unlike body_set_centroid(), the displacement counts as motion during the
+ * current tick (see body_get_sweep()), so it is used by solvers that
+ * correct positions after the bodies are ticked.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param dx the displacement to apply
+ */
+void body_translate(body_t *body, vector_t dx);
+
 void body_set_position(body_t *body, vector_t pos);
 
 /**
@@ -141,6 +267,58 @@ vector_t body_get_acceleration(body_t *body);
  */
 void body_set_rotation(body_t *body, double angle);
 
+/**
+ * Gets a body's orientation in the plane.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's angle in radians, counterclockwise
+ */
+double body_get_rotation(body_t *body);
+
+/**
+ * Gets a body's moment of inertia about its center of mass.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's moment of inertia, or INFINITY if it can't rotate
+ */
+double body_get_inertia(body_t *body);
+
+/**
+ * Lets a body rotate, giving it the moment of inertia of its shape
+ * with uniform density.
+ *
+ * @param body a pointer to a body returned from body_init(),
+ *   which must have finite mass
+ */
+void body_enable_rotation(body_t *body);
+
+/**
+ * Overrides a body's moment of inertia.
+ * Setting it to INFINITY locks the body's rotation and stops it spinning.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param inertia the new moment of inertia, which must be positive
+ */
+void body_set_inertia(body_t *body, double inertia);
+
+/**
+ * Gets a body's angular velocity.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's angular velocity in radians per second,
+ *   positive is counterclockwise
+ */
+double body_get_angular_velocity(body_t *body);
+
+/**
+ * Sets a body's angular velocity.
+ * Does nothing if the body has infinite inertia.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param omega the body's new angular velocity in radians per second
+ */
+void body_set_angular_velocity(body_t *body, double omega);
+
 void body_set_acceleration(body_t *body, vector_t new_acl);
 
 /**
@@ -161,6 +339,33 @@ void body_set_color(body_t *body, color_t color);
  */
 void body_add_force(body_t *body, vector_t force);
 
+/**
+ * Applies a force to a body at a point over the current tick.
+ * Also applies the torque the force exerts about the body's centroid.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param force the force vector to apply
+ * @param point where the force is applied, in world coordinates
+ */
+void body_add_force_at(body_t *body, vector_t force, vector_t point);
+
+/**
+ * Applies a torque to a body over the current tick.
+ * If multiple torques are applied in the same tick, they should be added.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param torque the torque to apply, positive is counterclockwise
+ */
+void body_add_torque(body_t *body, double torque);
+
+/**
+ * Gets the torque accumulated on a body during the current tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the sum of the torques applied this tick
+ */
+double body_get_torque(body_t *body);
+
 list_t *vector_pts(vector_t start, vector_t acl);
 
 /**
@@ -170,6 +375,145 @@ list_t *vector_pts(vector_t start, vector_t acl);
  */
 void body_draw_acl(body_t *body);
 
+/**
+ * Flags a body as a fast-moving projectile.
+ * Collisions involving a bullet are tested against the region it swept
+ * through during its last tick, so it cannot tunnel through thin bodies
+ * when it moves further than their width in a single tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param bullet whether the body should use swept collision detection
+ */
+void body_set_bullet(body_t *body, bool bullet);
+
+/**
+ * Returns whether a body was flagged with body_set_bullet().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body uses swept collision detection
+ */
+bool body_is_bullet(body_t *body);
+
+/**
+ * Gets how far the body's centroid moved during its most recent tick.
+ * Teleporting the body with body_set_centroid() resets this to zero.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's displacement over the last tick
+ */
+vector_t body_get_sweep(body_t *body);
+
+/**
+ * Counts how many times body_set_centroid() has teleported the body.
+ * Renderers compare this between frames so they don't smear a body
+ * across a jump it never travelled.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the number of teleports so far
+ */
+uint32_t body_get_teleports(body_t *body);
+
+/**
+ * Gets a number no other body has had, unlike the body's address,
+ * which a body allocated after this one is freed may reuse.
+ * Renderers use it to recognise the same body from one frame to the next.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's serial number, never 0
+ */
+size_t body_get_serial(body_t *body);
+
+/**
+ * Returns whether a body is asleep.
+ * The scene skips integrating sleeping bodies, evaluating force creators
+ * whose bodies are all asleep, and solving contacts between sleeping bodies.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body is asleep
+ */
+bool body_is_asleep(body_t *body);
+
+/**
+ * Puts a body to sleep.
+ * Zeroes its velocities and discards any forces and impulses
+ * accumulated during the current tick.
+ * A scene keeps the body asleep until something wakes it, like the bodies
+ * it puts to sleep itself.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_sleep(body_t *body);
+
+/**
+ * Wakes a body up and restarts its rest counter.
+ * Does nothing if the body is already awake.
+ * Called automatically when a nonzero force, torque, impulse or velocity
+ * is applied to the body, or when it is moved with body_set_centroid().
+ * Forces and impulses on bodies with infinite mass don't wake them.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_wake(body_t *body);
+
+/**
+ * Wakes two bodies that touch each other, like body_wake(),
+ * except those with infinite mass, which never need to move.
+ *
+ * @param body1 a pointer to a body returned from body_init()
+ * @param body2 a pointer to a body returned from body_init()
+ */
+void body_wake_pair(body_t *body1, body_t *body2);
+
+/**
+ * Counts one more tick at rest if the body's linear and angular speeds
+ * are below the sleep thresholds, or resets the count otherwise.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_update_still_ticks(body_t *body);
+
+/**
+ * Gets the number of consecutive ticks the body has been at rest,
+ * as counted by body_update_still_ticks().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the number of ticks at rest
+ */
+size_t body_get_still_ticks(body_t *body);
+
+/**
+ * Gets the island index assigned to the body by body_set_island().
+ * The scene uses it as scratch space while grouping bodies into islands.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's island index
+ */
+size_t body_get_island(body_t *body);
+
+/**
+ * Assigns an island index to a body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param island the index to store
+ */
+void body_set_island(body_t *body, size_t island);
+
+/**
+ * Gets the handle the body was given when it was added to a scene.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's handle, or a zeroed handle if it isn't in a scene
+ */
+body_handle_t body_get_handle(body_t *body);
+
+/**
+ * Stores a body's handle. Called by scene_add_body().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param handle the handle of the body in its scene
+ */
+void body_set_handle(body_t *body, body_handle_t handle);
+
 bool body_get_glow(body_t *body);
 
 void body_set_glow(body_t *body, bool glow);
@@ -192,13 +536,50 @@ void body_draw_glow(body_t *body, double radius);
  */
 void body_add_impulse(body_t *body, vector_t impulse);
 
+/**
+ * Gets the impulse accumulated on a body during the current tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the sum of the impulses passed to body_add_impulse() this tick
+ */
+vector_t body_get_impulse(body_t *body);
+
+/**
+ * Applies an impulse to a body at a point.
+ * Also applies the angular impulse it exerts about the body's centroid.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param impulse the impulse vector to apply
+ * @param point where the impulse is applied, in world coordinates
+ */
+void body_add_impulse_at(body_t *body, vector_t impulse, vector_t point);
+
+/**
+ * Applies an angular impulse to a body, causing an instantaneous change
+ * in its angular velocity.
+ * If multiple angular impulses are applied in the same tick, they should
+ * be added.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param impulse the angular impulse to apply, positive is counterclockwise
+ */
+void body_add_angular_impulse(body_t *body, double impulse);
+
+/**
+ * Gets the angular impulse accumulated on a body during the current tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the sum of the angular impulses applied this tick
+ */
+double body_get_angular_impulse(body_t *body);
+
 /**
  * Updates the body after a given time interval has elapsed.
  * Sets acceleration and velocity according to the forces and impulses
  * applied to the body during the tick.
  * The body should be translated at the *average* of the velocities before
- * and after the tick.
- * Resets the forces and impulses accumulated on the body.
+ * and after the tick, and rotated at the average of its angular velocities.
+ * Resets the forces, torques and impulses accumulated on the body.
  *
  * @param body the body to tick
  * @param dt the number of seconds elapsed since the last tick
@@ -210,7 +591,8 @@ void body_tick(body_t *body, double dt);
  * Sets acceleration and velocity according to the forces and impulses
  * applied to the body during the tick.
  * The body should be translated at the *new velocity* calculated
- * Resets the forces and impulses accumulated on the body.
+ * (and rotated at the new angular velocity).
+ * Resets the forces, torques and impulses accumulated on the body.
  *
  * @param body the body to tick
  * @param dt the number of seconds elapsed since the last tick
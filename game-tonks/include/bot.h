@@ -0,0 +1,52 @@
+#ifndef __BOT_H__
+#define __BOT_H__
+
+#include "list.h"
+#include "player.h"
+#include "spatial_hash.h"
+#include "vector.h"
+
+/**
+ * A heuristic controller that plays a slug instead of a keyboard.
+ * It steers through the same fields the keys set (turn_left and turn_right,
+ * see player_turn()) and dashes and shoots with player_dash() and
+ * player_shoot() once their cooldowns allow, so a bot exercises exactly
+ * the code a human player would.
+ * A bot heads for the nearest pellet it can see, wanders when it sees none,
+ * turns back from the walls, and shoots at heads in front of it.
+ * Bots only rethink their plans every so often, at staggered times,
+ * so many of them can play at once.
+ */
+typedef struct bot bot_t;
+
+/**
+ * Allocates a bot that plays a given player.
+ *
+ * @param player the player to control, which the bot doesn't own
+ * @param arena_min the bottom left corner of the area to stay in
+ * @param arena_max the top right corner of the area to stay in
+ * @return the new bot
+ */
+bot_t *bot_init(player_t *player, vector_t arena_min, vector_t arena_max);
+
+/**
+ * Releases a bot. Its player is not freed.
+ *
+ * @param bot a pointer to a bot returned from bot_init()
+ */
+void bot_free(void *bot);
+
+player_t *bot_get_player(bot_t *bot);
+
+/**
+ * Lets a bot look around if it is time to, then steers its player.
+ * Call once per tick, before player_turn().
+ *
+ * @param bot a pointer to a bot returned from bot_init()
+ * @param players every player in the game, including the bot's own
+ * @param food the pellets the bot can go after
+ * @param dt the length of the tick, in seconds
+ */
+void bot_tick(bot_t *bot, list_t *players, spatial_hash_t *food, double dt);
+
+#endif // #ifndef __BOT_H__
@@ -19,6 +19,11 @@ typedef struct {
      * If collided is false, this value is undefined.
      */
     vector_t axis;
+    /**
+     * If the shapes are colliding, how far they overlap along the axis.
+     * If collided is false, this value is undefined.
+     */
+    double depth;
 } collision_info_t;
 
 /**
@@ -34,4 +39,54 @@ typedef struct {
  */
 collision_info_t find_collision(list_t *shape1, list_t *shape2);
 
+/**
+ * Like find_collision(), but also reports shapes that are separated
+ * by a gap of at most margin along every axis as colliding.
+ * This lets contacts start acting just before the shapes touch, so resting
+ * contacts don't flicker between touching and separated.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param margin the largest gap that still counts as a collision
+ * @return whether the shapes are colliding, and if so, the collision axis
+ * and depth. The depth is negative if the shapes are separated by a gap.
+ */
+collision_info_t find_collision_with_margin(list_t *shape1, list_t *shape2,
+                                            double margin);
+
+/**
+ * Computes the status of the collision between a moving convex polygon
+ * and another convex polygon over the last tick.
+ * shape1 is treated as the region it swept through while translating
+ * by sweep1 to reach its current position (the convex hull of its previous
+ * and current vertices), so a collision is reported even if shape1 passed
+ * completely through shape2 during the tick.
+ *
+ * @param shape1 the moving shape, at its current position
+ * @param sweep1 how far shape1 moved relative to shape2 during the tick
+ * @param shape2 the other shape
+ * @return whether the swept shape collides with shape2, and if so, the
+ * collision axis, as in find_collision()
+ */
+collision_info_t find_swept_collision(list_t *shape1, vector_t sweep1,
+                                      list_t *shape2);
+
+/**
+ * Estimates the point where two colliding convex polygons touch.
+ * Picks the face of either shape that lies flattest against the collision
+ * axis as the reference face and clips the other shape's facing edge
+ * against it. Returns the middle of the clipped points that are (nearly)
+ * as deep as the deepest one, halfway between the two shapes.
+ * For resting face-to-face contacts this is the center of the shared edge,
+ * so the contact impulse doesn't spin the bodies.
+ * The shapes are given as lists of vertices in counterclockwise order.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param axis the collision axis, a unit vector pointing from shape1
+ *   towards shape2 (see find_collision())
+ * @return the contact point, in world coordinates
+ */
+vector_t find_contact_point(list_t *shape1, list_t *shape2, vector_t axis);
+
 #endif // #ifndef __COLLISION_H__
@@ -20,6 +20,20 @@ collision_package_t *collision_package_init(body_t *body1, body_t *body2,
                                             collision_handler_t handler,
                                             void *aux, free_func_t freer);
 
+/**
+ * Tests two bodies for a collision and calls the handler if they collide,
+ * waking them up first.
+ * If either body is a bullet, its shape is swept over its motion
+ * relative to the other body during the last tick.
+ *
+ * @param body1 the first body passed to the handler
+ * @param body2 the second body passed to the handler
+ * @param handler the function to call if the bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ */
+void collision_handle_bodies(body_t *body1, body_t *body2,
+                             collision_handler_t handler, void *aux);
+
 void collision_package_handle(collision_package_t *pkg);
 
 void collision_package_free(void *pkg);
@@ -0,0 +1,115 @@
+#ifndef __CONSTRAINT_H__
+#define __CONSTRAINT_H__
+
+#include "body.h"
+#include "list.h"
+#include "vector.h"
+#include <stdbool.h>
+
+/**
+ * A joint that keeps the distance between two bodies' centroids
+ * within a range [min_length, max_length].
+ * A distance joint has min_length == max_length;
+ * a rope (max-distance) joint has min_length == 0 and can go slack.
+ *
+ * Constraints are solved on positions after the bodies are ticked,
+ * using extended position-based dynamics (XPBD): each violated constraint
+ * moves its bodies back into range (in proportion to their inverse masses)
+ * and adds the correction to their velocities.
+ * Unlike stiff springs, rigid constraints stay stable at any timestep.
+ */
+typedef struct constraint constraint_t;
+
+/**
+ * Allocates memory for a constraint between two bodies.
+ * At least one of the bodies must have a finite mass.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param min_length the smallest allowed distance between the centroids
+ * @param max_length the largest allowed distance between the centroids
+ * @param compliance the inverse stiffness of the constraint;
+ *   0 makes it rigid, larger values let it stretch like a soft spring
+ * @return a pointer to the newly allocated constraint
+ */
+constraint_t *constraint_init(body_t *body1, body_t *body2, double min_length,
+                              double max_length, double compliance);
+
+/**
+ * Makes a constraint only move its first body, as if the second body had
+ * an infinite mass. This lets a chain of bodies follow its leader without
+ * slowing it down.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @param one_way whether only body1 should be corrected
+ */
+void constraint_set_one_way(constraint_t *constraint, bool one_way);
+
+/**
+ * Gets the first body passed to constraint_init().
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @return the first body of the constraint
+ */
+body_t *constraint_get_body1(constraint_t *constraint);
+
+/**
+ * Gets the second body passed to constraint_init().
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @return the second body of the constraint
+ */
+body_t *constraint_get_body2(constraint_t *constraint);
+
+/**
+ * Returns whether the constraint involves a given body.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @param body the body to look for
+ * @return whether body is one of the constraint's bodies
+ */
+bool constraint_has_body(constraint_t *constraint, body_t *body);
+
+/**
+ * Marks a constraint for removal from its scene, e.g. because one of its
+ * bodies was removed. The scene frees it at the end of the tick.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ */
+void constraint_remove(constraint_t *constraint);
+
+/**
+ * Returns whether constraint_remove() has been called on a constraint.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @return whether the constraint is marked for removal
+ */
+bool constraint_is_removed(constraint_t *constraint);
+
+/**
+ * Resets the multiplier accumulated by the solver.
+ * Must be called at the start of every tick, before constraint_solve().
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ */
+void constraint_reset(constraint_t *constraint);
+
+/**
+ * Performs one Gauss-Seidel iteration on the constraint.
+ * If the bodies are out of range, moves them back into range and
+ * adds the resulting displacement (divided by dt) to their velocities.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ * @param dt the length of the tick, in seconds
+ */
+void constraint_solve(constraint_t *constraint, double dt);
+
+/**
+ * Releases the memory allocated for a constraint.
+ * Does not free the bodies.
+ *
+ * @param constraint a pointer to a constraint returned from constraint_init()
+ */
+void constraint_free(void *constraint);
+
+#endif // #ifndef __CONSTRAINT_H__
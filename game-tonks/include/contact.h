@@ -0,0 +1,125 @@
+#ifndef __CONTACT_H__
+#define __CONTACT_H__
+
+#include "body.h"
+#include "list.h"
+#include "vector.h"
+#include <stdbool.h>
+
+/**
+ * A persistent contact constraint between two bodies.
+ * Contacts are solved together by the scene's sequential-impulse solver,
+ * which pushes the bodies apart along the collision axis whenever they
+ * overlap. Bodies that can rotate are pushed at their contact point.
+ * Bodies separated by a small gap are solved too, but only stopped from
+ * closing more than the gap, so resting contacts don't flicker.
+ * The impulse accumulated by the solver is kept between ticks
+ * and used to warm start the next tick, so resting contacts converge
+ * in a few iterations instead of jittering.
+ */
+typedef struct contact contact_t;
+
+/**
+ * Allocates memory for a contact between two bodies.
+ * At least one of the bodies must have a finite mass.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param elasticity the "coefficient of restitution" of the contact;
+ * 0 is a perfectly inelastic collision and 1 is a perfectly elastic collision
+ * @return a pointer to the newly allocated contact
+ */
+contact_t *contact_init(body_t *body1, body_t *body2, double elasticity);
+
+/**
+ * Gets the first body passed to contact_init().
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @return the first body of the contact
+ */
+body_t *contact_get_body1(contact_t *contact);
+
+/**
+ * Gets the second body passed to contact_init().
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @return the second body of the contact
+ */
+body_t *contact_get_body2(contact_t *contact);
+
+/**
+ * Returns whether the bodies were overlapping (or within a small gap)
+ * during the last call to contact_prepare().
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @return whether the contact is currently being solved
+ */
+bool contact_is_touching(contact_t *contact);
+
+/**
+ * Gets the total normal impulse the solver applied during the last tick.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @return the accumulated impulse, which is never negative
+ */
+double contact_get_impulse(contact_t *contact);
+
+/**
+ * Runs collision detection for the contact and readies it for solving.
+ * If the bodies overlap (or are within a small gap), computes the collision
+ * axis, the contact point (if either body can rotate), the position
+ * correction bias and the effective mass, and warm starts the contact by
+ * reapplying the impulse accumulated during the previous tick.
+ * Otherwise, the accumulated impulse is discarded.
+ * Must be called after the forces of the tick have been applied.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @param dt the length of the tick, in seconds
+ */
+void contact_prepare(contact_t *contact, double dt);
+
+/**
+ * Performs one sequential-impulse iteration on the contact.
+ * Applies the impulse needed to stop the bodies from approaching each other
+ * (plus the restitution and position correction targets),
+ * clamping the accumulated impulse so the contact only ever pushes.
+ * Does nothing if the bodies were not touching in contact_prepare().
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ */
+void contact_solve(contact_t *contact);
+
+/**
+ * Returns whether the contact involves a given body.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @param body the body to look for
+ * @return whether body is one of the contact's bodies
+ */
+bool contact_has_body(contact_t *contact, body_t *body);
+
+/**
+ * Marks a contact for removal from its scene, e.g. because one of its
+ * bodies was removed. The scene frees it at the end of the tick.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ */
+void contact_remove(contact_t *contact);
+
+/**
+ * Returns whether contact_remove() has been called on a contact.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ * @return whether the contact is marked for removal
+ */
+bool contact_is_removed(contact_t *contact);
+
+/**
+ * Releases the memory allocated for a contact.
+ * Does not free the bodies.
+ *
+ * @param contact a pointer to a contact returned from contact_init()
+ */
+void contact_free(void *contact);
+
+#endif // #ifndef __CONTACT_H__
@@ -40,6 +40,23 @@ force_wrapper_t *force_init_with_bodies(force_creator_t force_creator,
  */
 list_t *force_get_bodies(force_wrapper_t *f);
 
+/**
+ * Marks a force as a collision check rather than a physical interaction.
+ * Collision checks don't join their bodies into the same sleep island.
+ *
+ * @param f the force_wrapper_t
+ * @param collision whether the force only detects collisions
+ */
+void force_set_collision(force_wrapper_t *f, bool collision);
+
+/**
+ * Returns whether a force was marked with force_set_collision()
+ *
+ * @param f the force_wrapper_t
+ * @return whether the force only detects collisions
+ */
+bool force_is_collision(force_wrapper_t *f);
+
 /**
  * Creates a force using the force creator
  * Passes in the aux value
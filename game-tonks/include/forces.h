@@ -3,17 +3,6 @@
 
 #include "scene.h"
 
-/**
- * A function called when a collision occurs.
- * @param body1 the first body passed to create_collision()
- * @param body2 the second body passed to create_collision()
- * @param axis a unit vector pointing from body1 towards body2
- *   that defines the direction the two bodies are colliding in
- * @param aux the auxiliary value passed to create_collision()
- */
-typedef void (*collision_handler_t)
-    (body_t *body1, body_t *body2, vector_t axis, void *aux);
-
 /**
  * Adds a force creator to a scene that applies gravity between two bodies.
  * The force creator will be called each tick
@@ -42,6 +31,45 @@ void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *b
  */
 void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2);
 
+/**
+ * Adds a constraint to a scene that keeps two bodies a fixed distance apart.
+ * Unlike create_spring(), the joint is rigid at any timestep.
+ * See constraint_init().
+ *
+ * @param scene the scene containing the bodies
+ * @param length the distance to keep between the bodies' centroids
+ * @param body1 the first body
+ * @param body2 the second body
+ */
+void create_distance_joint(scene_t *scene, double length, body_t *body1,
+                           body_t *body2);
+
+/**
+ * Adds a constraint to a scene that keeps two bodies at most
+ * a given distance apart, like a rope (a max-distance joint).
+ * The bodies move freely while the rope is slack.
+ *
+ * @param scene the scene containing the bodies
+ * @param max_length the largest distance allowed between the bodies' centroids
+ * @param body1 the first body
+ * @param body2 the second body
+ */
+void create_rope_joint(scene_t *scene, double max_length, body_t *body1,
+                       body_t *body2);
+
+/**
+ * Adds a distance joint to a scene that only moves the follower,
+ * so the leader drags it along without being slowed down by it.
+ * Chaining follow joints makes a trail of bodies behind a leader.
+ *
+ * @param scene the scene containing the bodies
+ * @param length the distance to keep between the bodies' centroids
+ * @param follower the body that is moved to satisfy the joint
+ * @param leader the body that is followed
+ */
+void create_follow_joint(scene_t *scene, double length, body_t *follower,
+                         body_t *leader);
+
 /**
  * Adds a force creator to a scene that applies a drag force on a body.
  * The force creator will be called each tick
@@ -101,15 +129,13 @@ void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2);
 void create_applied_force(scene_t *scene, double *magnitude, body_t *body);
 
 /**
- * Adds a force creator to a scene that applies impulses
+ * Adds a contact to a scene that applies impulses
  * to resolve collisions between two bodies in the scene.
- * This should be represented as an on-collision callback
- * registered with create_collision().
- *
- * You may remember from project01 that you should avoid applying impulses
- * multiple times while the bodies are still colliding.
- * You should also have a special case that allows either body1 or body2
- * to have mass INFINITY, as this is useful for simulating walls.
+ * The contact is solved together with every other contact in the scene
+ * by the scene's iterative solver (see scene_add_contact()),
+ * which also pushes overlapping bodies apart.
+ * Either body1 or body2 may have mass INFINITY,
+ * as this is useful for simulating walls.
  *
  * @param scene the scene containing the bodies
  * @param elasticity the "coefficient of restitution" of the collision;
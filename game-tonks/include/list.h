@@ -1,6 +1,7 @@
 #ifndef __LIST_H__
 #define __LIST_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /**
@@ -77,4 +78,24 @@ void *list_remove(list_t *list, size_t index);
  */
 void list_add(list_t *list, void *value);
 
+/**
+ * Removes every element from a list, calling its freer on them if it has one.
+ * The list keeps its capacity, so it can be refilled without allocating,
+ * e.g. when the same list collects the results of many queries.
+ *
+ * @param list a pointer to a list returned from list_init()
+ */
+void list_clear(list_t *list);
+
+/**
+ * Removes every element a predicate holds for, calling the list's freer on
+ * them if it has one, and keeps the other elements in order.
+ * The list is compacted in a single pass, whereas calling list_remove()
+ * on each element would move the rest of the list every time.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param removed returns whether an element should be removed
+ */
+void list_remove_if(list_t *list, bool (*removed)(void *));
+
 #endif // #ifndef __LIST_H__
\ No newline at end of file
@@ -10,15 +10,75 @@
 #include "string.h"
 #include "sdl_wrapper.h"
 #include "scene.h"
+#include "snapshot.h"
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
+/**
+ * The categories of the game's bodies (see body_tag_t).
+ * The owner of a slug's or bullet's tag is the id of its player.
+ */
+typedef enum {
+  CATEGORY_HEAD = 1 << 0,    // the first segment of a slug, subtype 0
+  CATEGORY_SEGMENT = 1 << 1, // any other, whose subtype is its chain index
+  CATEGORY_BULLET = 1 << 2,
+  CATEGORY_FOOD = 1 << 3,   // a pellet, whose subtype is its powerup_t
+  CATEGORY_WALL = 1 << 4,   // a wall, whose subtype is the side it is on
+  CATEGORY_CHOICE = 1 << 5, // a color choice on the menu
+  CATEGORY_PLAYER = CATEGORY_HEAD | CATEGORY_SEGMENT
+} category_t;
+
+/**
+ * The powerups a pellet can grant.
+ */
+typedef enum {
+  PU_BASE_SPEED,
+  PU_BULLET_SPEED,
+  PU_ROTATE_RATE,
+  PU_DASH_BOOST,
+  PU_COUNT
+} powerup_t;
+
+/**
+ * What a powerup looks like and what it does.
+ * The stat a powerup boosts is base + boost * sqrt(n)
+ * for a player who has eaten n of it.
+ */
+typedef struct powerup_info {
+  color_t color;     // the color of its pellets
+  const char *sound; // played when it is eaten
+  const char *text;  // flashed where it was eaten
+  double base;
+  double boost;
+  // the sound's handle, SIZE_MAX until powerups_load_sounds() sets it
+  size_t sound_id;
+} powerup_info_t;
+
+/**
+ * Every powerup, indexed by powerup_t.
+ * Only the sound handles change, once, in powerups_load_sounds().
+ */
+extern powerup_info_t POWERUPS[PU_COUNT];
+
+/**
+ * Loads every powerup's sound into the sound cache (see sdl_load_sound())
+ * and keeps its handle in POWERUPS, so eating a pellet doesn't look it up.
+ * Must be called once at startup, before any pellet is eaten.
+ */
+void powerups_load_sounds(void);
+
 typedef struct player {
   size_t player_id;
   list_t *meta_bodies;
+  // a fixed pool of bullet bodies, fired in turn like a ring buffer;
+  // bullets out of play are parked (see player_park_bullet())
+  list_t *bullets;
+  double *bullet_ages; // how long each bullet has been flying
+  size_t next_bullet;  // the pool index of the next bullet to fire
   text_t *score_tag;
+  text_t *buff_tag; // shows the last powerup eaten, reused for each one
 
   // physics state
   double *ph_applied_force_magnitude;
@@ -47,11 +107,8 @@ typedef struct player {
   double cd_shoot;
   double cd_collide_player;
   
-  // powerups
-  size_t pu_base_speed;
-  size_t pu_bullet_speed;
-  size_t pu_rotate_rate;
-  size_t pu_dash_boost;
+  // how many of each powerup_t the player has eaten
+  size_t pu_counts[PU_COUNT];
 } player_t;
 
 player_t *player_init(size_t player_id, color_t color, vector_t pos, char left_key, char right_key, char boost_key, char shoot_key);
@@ -66,19 +123,32 @@ void player_turn(player_t *p);
 
 void player_dash(player_t *p);
 
+/**
+ * Fires the player's next pooled bullet, recycling the oldest one
+ * if they are all in flight, so shooting never allocates.
+ *
+ * @param p the player shooting
+ * @return the bullet fired, which is already in the scene
+ */
 body_t *player_shoot(player_t *p);
 
-void player_eat(player_t *p, body_t *food, scene_t *scene);
+/**
+ * Takes a bullet out of play until it is fired again: it loses its
+ * category so it collides with nothing, and sleeps out of sight.
+ *
+ * @param bullet a bullet from a player's pool
+ */
+void player_park_bullet(body_t *bullet);
+
+void player_eat(player_t *p, body_t *food);
 
 body_t *player_body(player_t *p);
 
 void player_update_stats(player_t *p);
 
-void player_draw_inner_glow(player_t *p);
-
-void player_render_cosmetics_below(player_t *p);
+void player_draw_inner_glow(player_t *p, snapshot_t *snapshot);
 
-void player_render_cosmetics_above(player_t *p);
+void player_render_cosmetics_above(player_t *p, snapshot_t *snapshot);
 
 void player_hit(player_t *predator, player_t *prey, body_t *body, scene_t *scene);
 
@@ -86,7 +156,7 @@ vector_t player_head_pos(player_t *p);
 
 vector_t player_tail_pos(player_t *p);
 
-char *player_get_score(player_t *p);
+size_t player_get_score(player_t *p);
 
 void player_update_kills(player_t *p);
 
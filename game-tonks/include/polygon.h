@@ -26,6 +26,19 @@ double polygon_area(list_t *polygon);
  */
 vector_t polygon_centroid(list_t *polygon);
 
+/**
+ * Computes the moment of inertia of a polygon with uniform density
+ * about its center of mass.
+ * See https://en.wikipedia.org/wiki/List_of_moments_of_inertia.
+ *
+ * @param polygon the list of vertices that make up the polygon,
+ * listed in a counterclockwise direction. There is an edge between
+ * each pair of consecutive vertices, plus one between the first and last.
+ * @param mass the mass of the polygon
+ * @return the moment of inertia of the polygon about its centroid
+ */
+double polygon_moment_of_inertia(list_t *polygon, double mass);
+
 /**
  * Translates all vertices in a polygon by a given vector.
  * Note: mutates the original polygon.
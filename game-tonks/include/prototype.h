@@ -0,0 +1,93 @@
+#ifndef __PROTOTYPE_H__
+#define __PROTOTYPE_H__
+
+#include "list.h"
+#include "vector.h"
+#include <stddef.h>
+
+/**
+ * A shape shared by many bodies, e.g. every slug segment or bullet.
+ * A prototype stores its vertices relative to its centroid, along with
+ * their triangulation, so bodies only need to store where the shape is
+ * and how it is rotated (see body_init_with_prototype()).
+ * Prototypes are built the first time they are asked for and are kept
+ * until prototype_free_all() is called.
+ */
+typedef struct prototype prototype_t;
+
+/**
+ * Gets the prototype of a regular polygon approximating a circle,
+ * building it the first time a resolution and radius are used.
+ * The first vertex lies on the positive x axis and the rest follow
+ * counterclockwise, like the vertices of make_circle().
+ *
+ * @param resolution the number of vertices of the polygon (at least 3)
+ * @param radius the distance from the center to each vertex
+ * @return the shared prototype, which must not be freed
+ */
+prototype_t *prototype_get_round(size_t resolution, double radius);
+
+/**
+ * Gets the vertices of a prototype, relative to its centroid.
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @return the prototype's vertices, which must not be modified or freed
+ */
+list_t *prototype_get_points(prototype_t *prototype);
+
+/**
+ * Gets the distance from a prototype's centroid to its farthest vertex,
+ * which bounds the shape however it is rotated.
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @return the radius of the smallest circle around the centroid holding
+ *   the shape
+ */
+double prototype_get_radius(prototype_t *prototype);
+
+/**
+ * Gets the triangulation of a prototype, as triples of indices into
+ * the list returned by prototype_get_points().
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @return an array of 3 * prototype_get_triangle_count() indices
+ */
+const size_t *prototype_get_triangles(prototype_t *prototype);
+
+/**
+ * Gets the number of triangles in the triangulation of a prototype.
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @return the number of triangles
+ */
+size_t prototype_get_triangle_count(prototype_t *prototype);
+
+/**
+ * Computes the moment of inertia of a prototype with uniform density
+ * about its centroid, without going through its vertices again.
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @param mass the mass of the shape
+ * @return the moment of inertia of the shape about its centroid
+ */
+double prototype_get_inertia(prototype_t *prototype, double mass);
+
+/**
+ * Builds a copy of a prototype's shape at a given position and rotation.
+ * Returns a newly allocated vector list, which must be list_free()d.
+ *
+ * @param prototype a prototype returned from prototype_get_round()
+ * @param centroid where to put the prototype's centroid
+ * @param angle the angle to rotate the shape by, in radians.
+ * A positive angle means counterclockwise.
+ * @return the transformed shape
+ */
+list_t *prototype_place(prototype_t *prototype, vector_t centroid,
+                        double angle);
+
+/**
+ * Frees every prototype. Must only be called once no body uses them.
+ */
+void prototype_free_all(void);
+
+#endif // #ifndef __PROTOTYPE_H__
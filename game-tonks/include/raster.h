@@ -0,0 +1,137 @@
+#ifndef __RASTER_H__
+#define __RASTER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * An RGBA framebuffer in memory that triangles are rasterized onto
+ * without any window or GPU, e.g. to render frames on a headless machine
+ * or to compare frames pixel by pixel.
+ * Pixels are stored row by row from the top left corner, as r, g, b, a bytes.
+ */
+typedef struct raster raster_t;
+
+/**
+ * An RGBA image that triangles can be textured with.
+ */
+typedef struct raster_image raster_image_t;
+
+/**
+ * How a triangle's pixels are combined with the pixels under them,
+ * following SDL's blend modes.
+ */
+typedef enum {
+  RASTER_BLEND_NONE,  // the triangle replaces the pixels
+  RASTER_BLEND_ALPHA, // the triangle is drawn over the pixels
+  RASTER_BLEND_ADD    // the triangle's color is added to the pixels
+} raster_blend_t;
+
+/**
+ * A corner of a triangle: its position in pixels, its color,
+ * and the point of the image it is textured with (from 0 to 1),
+ * laid out like SDL_Vertex.
+ */
+typedef struct {
+  float x;
+  float y;
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t a;
+  float u;
+  float v;
+} raster_vertex_t;
+
+/**
+ * Allocates a framebuffer, cleared to transparent black.
+ *
+ * @param width the width of the framebuffer in pixels
+ * @param height the height of the framebuffer in pixels
+ * @return the new framebuffer
+ */
+raster_t *raster_init(size_t width, size_t height);
+
+/**
+ * Releases a framebuffer.
+ *
+ * @param raster a framebuffer returned from raster_init()
+ */
+void raster_free(raster_t *raster);
+
+size_t raster_get_width(raster_t *raster);
+
+size_t raster_get_height(raster_t *raster);
+
+/**
+ * Gets the framebuffer's pixels, 4 * width bytes per row.
+ *
+ * @param raster a framebuffer returned from raster_init()
+ * @return the pixels, which are owned by the framebuffer
+ */
+uint8_t *raster_get_pixels(raster_t *raster);
+
+/**
+ * Fills the whole framebuffer with an opaque color.
+ */
+void raster_clear(raster_t *raster, uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * Copies RGBA pixels into an image.
+ *
+ * @param width the width of the image in pixels
+ * @param height the height of the image in pixels
+ * @param pixels the image's pixels as r, g, b, a bytes, row by row
+ * @param pitch the number of bytes from the start of a row to the next
+ * @return the new image
+ */
+raster_image_t *raster_image_init(size_t width, size_t height,
+                                  const uint8_t *pixels, size_t pitch);
+
+/**
+ * Releases an image.
+ *
+ * @param image an image returned from raster_image_init()
+ */
+void raster_image_free(raster_image_t *image);
+
+/**
+ * Rasterizes triangles onto a framebuffer like SDL_RenderGeometry():
+ * each pixel whose center is inside a triangle gets the color interpolated
+ * between its corners, multiplied by the nearest texel of the image if any,
+ * and is blended onto the framebuffer.
+ * Triangles may wind either way.
+ *
+ * @param raster a framebuffer returned from raster_init()
+ * @param vertices the corners of the triangles
+ * @param indices the indices of each triangle's three corners in vertices
+ * @param index_count the number of indices, three per triangle
+ * @param image the image to texture the triangles with, or NULL
+ * @param blend how to combine the triangles with the framebuffer
+ */
+void raster_draw_triangles(raster_t *raster, const raster_vertex_t *vertices,
+                           const int *indices, size_t index_count,
+                           raster_image_t *image, raster_blend_t blend);
+
+/**
+ * Writes RGBA pixels to a binary PPM file, dropping their alpha.
+ *
+ * @param path the file to write
+ * @param pixels the pixels as r, g, b, a bytes, row by row
+ * @param width the width of the image in pixels
+ * @param height the height of the image in pixels
+ * @param pitch the number of bytes from the start of a row to the next
+ * @return whether the file was written
+ */
+bool raster_write_ppm(const char *path, const uint8_t *pixels, size_t width,
+                      size_t height, size_t pitch);
+
+/**
+ * Writes RGBA pixels to an uncompressed PNG file, like raster_write_ppm().
+ * The image data is stored without compression, so no zlib is needed.
+ */
+bool raster_write_png(const char *path, const uint8_t *pixels, size_t width,
+                      size_t height, size_t pitch);
+
+#endif // #ifndef __RASTER_H__
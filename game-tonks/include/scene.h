@@ -2,6 +2,8 @@
 #define __SCENE_H__
 
 #include "body.h"
+#include "constraint.h"
+#include "contact.h"
 #include "text.h"
 #include "list.h"
 
@@ -19,6 +21,18 @@ typedef struct scene scene_t;
  */
 typedef void (*force_creator_t)(void *aux);
 
+/**
+ * A function called when a collision occurs.
+ * @param body1 the first body passed to create_collision(), or the body
+ *   in the first categories passed to scene_add_category_collision()
+ * @param body2 the other body
+ * @param axis a unit vector pointing from body1 towards body2
+ *   that defines the direction the two bodies are colliding in
+ * @param aux the auxiliary value passed along with the handler
+ */
+typedef void (*collision_handler_t)
+    (body_t *body1, body_t *body2, vector_t axis, void *aux);
+
 /**
  * Allocates memory for an empty scene.
  * Makes a reasonable guess of the number of bodies to allocate space for.
@@ -59,13 +73,34 @@ list_t *scene_get_texts(scene_t *scene);
 body_t *scene_get_body(scene_t *scene, size_t index);
 
 /**
- * Adds a body to a scene.
+ * Adds a body to a scene and gives it a handle (see body_get_handle()).
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param body a pointer to the body to add to the scene
  */
 void scene_add_body(scene_t *scene, body_t *body);
 
+/**
+ * Looks up a body by its handle in constant time.
+ * Once the scene frees the body, its handle goes stale and no longer
+ * refers to any body, even after a new body reuses its slot.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param handle a handle returned from body_get_handle()
+ * @return the body, or NULL if the handle is stale
+ */
+body_t *scene_get_body_handle(scene_t *scene, body_handle_t handle);
+
+/**
+ * Marks the body with a given handle for removal, like body_remove().
+ * The body is freed on the next tick, which makes the handle stale.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param handle a handle returned from body_get_handle()
+ * @return whether the handle referred to a body
+ */
+bool scene_remove_body_handle(scene_t *scene, body_handle_t handle);
+
 void scene_add_text(scene_t *scene, text_t *text);
 
 /**
@@ -97,10 +132,12 @@ bool scene_get_dev_mode(scene_t *scene);
 void scene_set_dev_mode(scene_t *scene, bool dev_mode);
 
 /**
- * Removes any forces from a body in a scene
+ * Removes any forces, contacts and constraints from a body in a scene.
+ * They are found through the body's handle rather than by searching
+ * the scene, and freed at the end of the tick.
  *
  * @param scene a pointer to a scene returned from scene_init()
- * @param index the body that forces must be removed from
+ * @param body the body that forces must be removed from
  */
 void scene_remove_forces_from_body(scene_t *scene, body_t *body);
 
@@ -121,7 +158,8 @@ void scene_add_force_creator(scene_t *scene, force_creator_t forcer, void *aux,
  * @param scene a pointer to a scene returned from scene_init()
  * @param forcer a force creator function
  * @param aux an auxiliary value to pass to forcer when it is called
- * @param bodies the list of bodies affected by the force creator.
+ * @param bodies the list of bodies affected by the force creator,
+ *   which must already be in the scene.
  *   The force creator will be removed if any of these bodies are removed.
  *   This list does not own the bodies, so its freer should be NULL.
  * @param freer if non-NULL, a function to call in order to free aux
@@ -130,6 +168,163 @@ void scene_add_bodies_force_creator(scene_t *scene, force_creator_t forcer,
                                     void *aux, list_t *bodies,
                                     free_func_t freer);
 
+/**
+ * Adds a force creator that only detects collisions between its bodies,
+ * like scene_add_bodies_force_creator().
+ * Unlike physical forces, collision checks don't join their bodies into
+ * the same sleep island, so e.g. a moving body doesn't keep every pellet
+ * it could collide with awake.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param forcer a force creator function
+ * @param aux an auxiliary value to pass to forcer when it is called
+ * @param bodies the list of bodies checked by the force creator,
+ *   which must already be in the scene
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_bodies_collision_creator(scene_t *scene, force_creator_t forcer,
+                                        void *aux, list_t *bodies,
+                                        free_func_t freer);
+
+/**
+ * Adds an entry to a scene's collision dispatch table.
+ * Every tick, the handler is called for each pair of colliding bodies
+ * where one body's category (see body_set_tag()) is in categories1
+ * and the other's is in categories2, with the bodies in that order.
+ * Unlike create_collision(), nothing is registered per pair of bodies,
+ * so bodies added to the scene later are collidable as soon as they are
+ * tagged, and removed bodies simply drop out.
+ * Candidate pairs are found by sweeping the bodies' bounding boxes
+ * (grown to cover their motion over the last tick) along the x axis,
+ * so only bodies whose boxes overlap are tested for a collision.
+ * A pair is skipped once either body is removed or retagged out of the
+ * entry's categories, or while both are asleep, and like collision creators,
+ * the checks don't join sleep islands.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param categories1 a mask of the categories of the first body
+ * @param categories2 a mask of the categories of the second body
+ * @param handler a function to call whenever two such bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_category_collision(scene_t *scene, uint32_t categories1,
+                                  uint32_t categories2,
+                                  collision_handler_t handler, void *aux,
+                                  free_func_t freer);
+
+/**
+ * Adds a contact to a scene, to be solved every time scene_tick() is called.
+ * All of a scene's contacts are solved together by a sequential-impulse
+ * solver that runs after the force creators and before the bodies are ticked.
+ * The contact is freed when the scene is freed
+ * or when either of its bodies is removed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param contact a contact returned from contact_init(),
+ *   whose bodies must already be in the scene
+ */
+void scene_add_contact(scene_t *scene, contact_t *contact);
+
+/**
+ * Gets the number of velocity iterations the contact solver performs per tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of solver iterations
+ */
+size_t scene_get_solver_iterations(scene_t *scene);
+
+/**
+ * Sets the number of velocity iterations the contact solver performs per tick.
+ * More iterations make stacks and bodies with many contacts more rigid,
+ * at a cost proportional to the number of touching contacts.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param iterations the number of solver iterations
+ */
+void scene_set_solver_iterations(scene_t *scene, size_t iterations);
+
+/**
+ * Runs the contact solver stage of a tick on its own: prepares the scene's
+ * contacts, wakes the bodies of touching ones, and applies the solver
+ * iterations to every contact with an awake body.
+ * scene_tick() calls this after the force creators; it is exposed so the
+ * stage can be measured by itself.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param dt the time elapsed in the tick, in seconds
+ */
+void scene_solve_contacts(scene_t *scene, double dt);
+
+/**
+ * Adds a constraint to a scene, to be solved every time scene_tick() is called.
+ * Constraints are solved on the bodies' positions after the bodies are ticked.
+ * The constraint is freed when the scene is freed
+ * or when either of its bodies is removed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param constraint a constraint returned from constraint_init(),
+ *   whose bodies must already be in the scene
+ */
+void scene_add_constraint(scene_t *scene, constraint_t *constraint);
+
+/**
+ * Gets the number of position iterations the constraint solver performs
+ * per tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of constraint iterations
+ */
+size_t scene_get_constraint_iterations(scene_t *scene);
+
+/**
+ * Sets the number of position iterations the constraint solver performs
+ * per tick. Long chains of constraints need more iterations to stay rigid
+ * when the bodies are pulled from both ends.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param iterations the number of constraint iterations
+ */
+void scene_set_constraint_iterations(scene_t *scene, size_t iterations);
+
+/**
+ * Returns whether the scene puts resting bodies to sleep.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return whether sleeping is enabled
+ */
+bool scene_get_sleeping(scene_t *scene);
+
+/**
+ * Enables or disables sleeping. Sleeping is enabled by default.
+ * Bodies are grouped into islands connected by constraints, touching
+ * contacts and (non-collision) force creators; bodies with infinite mass
+ * don't connect islands. Once every body in an island has been at rest for
+ * a number of ticks, the whole island is put to sleep, and it wakes up
+ * as soon as any of its bodies does.
+ * Disabling sleeping wakes every body.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param sleeping whether resting bodies should be put to sleep
+ */
+void scene_set_sleeping(scene_t *scene, bool sleeping);
+
+/**
+ * Gets the number of bodies that were awake at the end of the last tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of awake bodies
+ */
+size_t scene_get_awake_bodies(scene_t *scene);
+
+/**
+ * Gets the number of bodies that were asleep at the end of the last tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of sleeping bodies
+ */
+size_t scene_get_asleep_bodies(scene_t *scene);
+
 /**
  * Draws all the bodies in a given scene
  *
@@ -139,10 +334,13 @@ void scene_draw(scene_t *scene);
 
 /**
  * Executes a tick of a given scene over a small time interval.
- * This requires executing all the force creators
- * and then ticking each body (see body_tick()).
+ * This requires executing all the force creators and the collision
+ * dispatch table, solving the contacts, ticking each body
+ * (see body_tick()) and then solving the constraints.
  * If any bodies are marked for removal, they should be removed from the scene
  * and freed, along with any force creators acting on them.
+ * Sleeping bodies are skipped, and islands are put to sleep or woken up
+ * at the end of the tick (see scene_set_sleeping()).
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param dt the time elapsed since the last tick, in seconds
@@ -151,8 +349,8 @@ void scene_tick(scene_t *scene, double dt);
 
 /**
  * Executes a canonical tick of a given scene over a small time interval.
- * This requires executing all the force creators
- * and then ticking each body (see body_tick()).
+ * This requires executing all the force creators, solving the contacts,
+ * ticking each body (see body_tick_canon()) and then solving the constraints.
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param dt the time elapsed since the last tick, in seconds
@@ -4,6 +4,7 @@
 #include "color.h"
 #include "scene.h"
 #include "list.h"
+#include "prototype.h"
 #include "state.h"
 #include "vector.h"
 #include <stdbool.h>
@@ -25,6 +26,15 @@ typedef enum {
  */
 typedef enum { KEY_PRESSED, KEY_RELEASED } key_event_type_t;
 
+/**
+ * The renderers that can draw frames without a window
+ * (see sdl_init_offscreen()).
+ */
+typedef enum {
+  RENDERER_SDL,     // SDL's software renderer, drawing onto a surface
+  RENDERER_SOFTWARE // the rasterizer in raster.h
+} renderer_type_t;
+
 /**
  * A keypress handler.
  * When a key is pressed or released, the handler is passed its char value.
@@ -52,6 +62,38 @@ void get_text_and_rect(void);
  */
 void sdl_init(vector_t min, vector_t max);
 
+/**
+ * Initializes the SDL wrapper without a window, e.g. on a headless machine.
+ * Frames are drawn in memory by the given renderer, and can be saved with
+ * sdl_save_frame(). No sound is played and no events are received.
+ * Must be called once before any of the other SDL functions,
+ * instead of sdl_init().
+ *
+ * @param min the x and y coordinates of the bottom left of the scene
+ * @param max the x and y coordinates of the top right of the scene
+ * @param width the width of the frames in pixels
+ * @param height the height of the frames in pixels
+ * @param type what draws the frames
+ */
+void sdl_init_offscreen(vector_t min, vector_t max, int width, int height,
+                        renderer_type_t type);
+
+/**
+ * Saves the last frame drawn offscreen (see sdl_init_offscreen()) as an image,
+ * in PNG format if the path ends with ".png" and in PPM format otherwise.
+ *
+ * @param path the file to write
+ * @return whether the frame was saved; frames drawn in a window can't be
+ */
+bool sdl_save_frame(const char *path);
+
+/**
+ * Destroys the window or offscreen frame and everything created to draw them:
+ * the renderer, the glyph atlas, the cached sprites and the loaded textures.
+ * The SDL wrapper can then be initialized again, e.g. with another renderer.
+ */
+void sdl_free(void);
+
 /**
  * Processes all SDL events and returns whether the window has been closed.
  * This function must be called in order to handle keypresses.
@@ -61,12 +103,16 @@ void sdl_init(vector_t min, vector_t max);
 bool sdl_is_done(state_t *state);
 
 /**
- * Clears the screen. Should be called before drawing polygons in each frame.
+ * Starts a new frame. Should be called before drawing anything in each frame.
+ * Everything drawn until sdl_end_frame() is queued in the order it was drawn,
+ * and nothing reaches the renderer until then.
  */
-void sdl_clear(void);
+void sdl_begin_frame(void);
 
 /**
  * Draws a polygon from the given list of vertices and a color.
+ * The polygon is split into triangles (a fan if it is convex, by clipping
+ * its ears otherwise) and queued with the rest of the frame.
  *
  * @param points the list of vertices of the polygon
  * @param color the color used to fill in the polygon
@@ -74,22 +120,136 @@ void sdl_clear(void);
 void sdl_draw_polygon(list_t *points, color_t color);
 
 /**
- * Displays the rendered frame on the SDL window.
- * Must be called after drawing the polygons in order to show them.
+ * Draws an instance of a prototype's shape, reusing its triangulation.
+ * Unlike sdl_draw_polygon(), no list of vertices has to be built for it,
+ * and nothing is queued if it is outside the window.
+ *
+ * @param prototype the prototype to draw
+ * @param centroid where to put the prototype's centroid
+ * @param angle the angle to rotate the shape by, in radians
+ * @param color the color used to fill in the shape
+ */
+void sdl_draw_prototype(prototype_t *prototype, vector_t centroid,
+                        double angle, color_t color);
+
+/**
+ * Draws the glow around a body: a soft halo that fades out over
+ * a few rings past the given radius, added onto whatever is below it.
+ * The halo is rendered into a texture the first time a radius is used,
+ * so each glow is drawn as a single textured quad.
+ *
+ * @param center the center of the glow
+ * @param radius the radius of the innermost (brightest) ring
+ * @param color the color of the glowing body
+ */
+void sdl_draw_glow(vector_t center, double radius, color_t color);
+
+/**
+ * Draws a filled circle as a single textured quad.
+ * The circle is rendered into a texture the first time a radius is used.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param color the color of the circle
+ */
+void sdl_draw_disc(vector_t center, double radius, color_t color);
+
+/**
+ * Draws the frame queued since sdl_begin_frame() and displays it
+ * on the SDL window. Consecutive draws that share a texture and blend mode
+ * are drawn with a single SDL_RenderGeometry() call, and the window is
+ * presented exactly once.
+ */
+void sdl_end_frame(void);
+
+/**
+ * Enables or disables dirty rendering. While it is enabled, frames are drawn
+ * onto a texture that is kept between frames, and only the parts of it
+ * covered by something that moved, changed, appeared or disappeared
+ * since the last frame are redrawn. This suits mostly static screens
+ * like menus; in a busy frame it only adds the cost of the extra copy.
+ * Falls back to redrawing everything if the renderer can't draw to textures.
+ * Disabled by default.
+ *
+ * @param enabled whether to redraw only what changed
+ */
+void sdl_set_dirty_rendering(bool enabled);
+
+/**
+ * Moves the camera, i.e. the point of the scene shown at the center of
+ * the window. The camera starts at the center of the scene passed to
+ * sdl_init(), and the window keeps showing the same amount of the scene.
+ *
+ * @param camera the point of the scene to center the window on
  */
-void sdl_show(void);
+void sdl_set_camera(vector_t camera);
 
 /**
- * Draws all bodies in a scene.
- * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
- * so those functions should not be called directly.
+ * Returns whether any part of a box in the scene is shown in the window,
+ * as of the last call to sdl_begin_frame() or sdl_set_camera().
+ * Drawing functions skip shapes and sprites that aren't visible,
+ * but checking first avoids building their vertices at all.
+ *
+ * @param min the bottom left corner of the box
+ * @param max the top right corner of the box
+ * @return whether the box overlaps the part of the scene in the window
+ */
+bool sdl_is_visible(vector_t min, vector_t max);
+
+/**
+ * Draws all visible bodies in a scene, queueing them with sdl_draw_polygon()
+ * (or sdl_draw_prototype()). Bodies whose bounds are outside the window
+ * are skipped without copying their shapes.
+ * Must be called between sdl_begin_frame() and sdl_end_frame().
  *
  * @param scene the scene to draw
  */
 void sdl_render_scene(scene_t *scene);
 
+/**
+ * Loads sound effects into the sound cache ahead of time,
+ * so playing them for the first time doesn't read them from disk mid-game.
+ *
+ * @param paths the paths of the .wav files to load
+ * @param count the number of paths
+ */
+void sdl_load_sounds(const char *paths[], size_t count);
+
+/**
+ * Loads a sound effect into the sound cache, or finds it if it is already
+ * there, so it can be played later without looking its path up again.
+ *
+ * @param path the path of the .wav file to load
+ * @return a handle to pass to sdl_play_loaded_sound(),
+ *   which stays valid until sdl_free_sounds()
+ */
+size_t sdl_load_sound(const char *path);
+
+/**
+ * Plays a sound effect loaded with sdl_load_sound() on a mixer channel.
+ *
+ * @param channel the channel to play on, or -1 for the first free channel
+ * @param sound a handle returned from sdl_load_sound()
+ * @param loops the number of times to repeat the sound, or -1 to loop forever
+ */
+void sdl_play_loaded_sound(int channel, size_t sound, int loops);
+
+/**
+ * Plays a sound effect on a mixer channel.
+ * Each file is only loaded from disk the first time it is played
+ * (or when it is passed to sdl_load_sounds()), and then kept in the cache.
+ *
+ * @param channel the channel to play on, or -1 for the first free channel
+ * @param path the path of the .wav file to play
+ * @param loops the number of times to repeat the sound, or -1 to loop forever
+ */
 void sdl_play_sound(int channel, char *path, int loops);
 
+/**
+ * Stops all sound effects and frees every sound in the cache.
+ */
+void sdl_free_sounds(void);
+
 /**
  * Registers a function to be called every time a key is pressed.
  * Overwrites any existing handler.
@@ -126,14 +286,52 @@ void sdl_on_key(key_handler_t handler);
  */
 double time_since_last_tick(void);
 
-list_t *sdl_prepare_text(char *text, vector_t center, double height, double width, color_t color);
+/**
+ * Draws a line of text from the glyph atlas, which holds every printable
+ * ASCII character of the font and is rasterized once by sdl_init().
+ * Drawing text doesn't rasterize anything or create any textures,
+ * so text can be edited or recolored every frame for free.
+ *
+ * @param text the characters to draw
+ * @param center the center of the text, in window coordinates with y up
+ * @param height the height of the text, in pixels
+ * @param width the width of each character, in pixels
+ * @param color the color of the text
+ */
+void sdl_draw_text(char *text, vector_t center, double height, double width,
+                   color_t color);
 
-void sdl_move_text(list_t *l, vector_t pos, double height, double width);
+/**
+ * Loads a .bmp image into a texture, or returns the handle of the texture
+ * if the image was already loaded. Images should be loaded once at startup,
+ * so drawing them doesn't read them from disk.
+ *
+ * @param path the path of the image
+ * @return a handle to pass to sdl_draw_texture() or sdl_draw_background()
+ */
+size_t sdl_load_texture(const char *path);
 
-void sdl_render_text(list_t *l);
+/**
+ * Draws a loaded texture stretched over a rectangle of the scene.
+ *
+ * @param texture a handle returned from sdl_load_texture()
+ * @param center the center of the rectangle
+ * @param width the width of the rectangle
+ * @param height the height of the rectangle
+ */
+void sdl_draw_texture(size_t texture, vector_t center, double width,
+                      double height);
 
-void sdl_free_text(list_t *texture);
+/**
+ * Draws a loaded texture stretched over the whole window.
+ *
+ * @param texture a handle returned from sdl_load_texture()
+ */
+void sdl_draw_background(size_t texture);
 
-void sdl_render_image();
+/**
+ * Frees every loaded texture. Their handles can't be used afterwards.
+ */
+void sdl_free_textures(void);
 
 #endif // #ifndef __SDL_WRAPPER_H__
@@ -0,0 +1,111 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "color.h"
+#include "prototype.h"
+#include "scene.h"
+#include "vector.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A record of what to draw for one tick: where each body, glow and text is,
+ * and what color it has, copied out of the scene so it can be drawn
+ * while the scene keeps changing (e.g. by another thread).
+ * Everything is drawn in the order it was added.
+ * A snapshot keeps its buffers when it is cleared, so recording one
+ * every tick doesn't allocate once the buffers are big enough.
+ */
+typedef struct snapshot snapshot_t;
+
+/**
+ * Allocates memory for an empty snapshot.
+ *
+ * @return the new snapshot
+ */
+snapshot_t *snapshot_init(void);
+
+/**
+ * Releases the memory allocated for a snapshot.
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ */
+void snapshot_free(snapshot_t *snapshot);
+
+/**
+ * Empties a snapshot so a new tick can be recorded into it.
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param time when the recorded tick happened, in seconds
+ */
+void snapshot_clear(snapshot_t *snapshot, double time);
+
+/**
+ * Gets the time passed to snapshot_clear().
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @return when the recorded tick happened, in seconds
+ */
+double snapshot_get_time(snapshot_t *snapshot);
+
+/**
+ * Records a texture covering the whole window (see sdl_draw_background()).
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param texture a handle returned from sdl_load_texture()
+ */
+void snapshot_add_background(snapshot_t *snapshot, size_t texture);
+
+/**
+ * Records the shape, position and color of every body in a scene.
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param scene the scene whose bodies to record
+ */
+void snapshot_add_bodies(snapshot_t *snapshot, scene_t *scene);
+
+/**
+ * Records the glow around every glowing body in a scene.
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param scene the scene whose glows to record
+ */
+void snapshot_add_glows(snapshot_t *snapshot, scene_t *scene);
+
+/**
+ * Records every text in a scene that hasn't been removed.
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param scene the scene whose texts to record
+ */
+void snapshot_add_texts(snapshot_t *snapshot, scene_t *scene);
+
+/**
+ * Records a filled circle (see sdl_draw_disc()).
+ *
+ * @param snapshot a pointer to a snapshot returned from snapshot_init()
+ * @param id the body_get_serial() of the body the disc belongs to, or 0,
+ *   so it can be matched with the same disc in another snapshot
+ * @param teleports body_get_teleports() of the body the disc belongs to,
+ *   or 0; the disc isn't interpolated between snapshots where this differs
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param color the color of the circle
+ */
+void snapshot_add_disc(snapshot_t *snapshot, size_t id,
+                       uint32_t teleports, vector_t center, double radius,
+                       color_t color);
+
+/**
+ * Draws a snapshot, interpolating the position of everything that was also
+ * recorded in an earlier snapshot. Must be called between sdl_begin_frame()
+ * and sdl_end_frame().
+ *
+ * @param previous the snapshot recorded before current, or NULL
+ * @param current the snapshot to draw
+ * @param alpha how far to go from previous towards current,
+ *   between 0 (as in previous) and 1 (as in current)
+ */
+void snapshot_draw(snapshot_t *previous, snapshot_t *current, double alpha);
+
+#endif // #ifndef __SNAPSHOT_H__
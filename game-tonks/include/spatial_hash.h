@@ -0,0 +1,83 @@
+#ifndef __SPATIAL_HASH_H__
+#define __SPATIAL_HASH_H__
+
+#include "body.h"
+#include "list.h"
+#include "vector.h"
+#include <stdbool.h>
+
+/**
+ * A uniform grid over the plane that finds the bodies near a point
+ * without looking at every body, e.g. the food around a slug's head.
+ * Each body is filed under the cell containing its centroid, and cells are
+ * hashed into a fixed number of buckets, so the grid is unbounded and only
+ * costs memory for the bodies in it.
+ * Bodies must not move while they are in the hash; remove a body before
+ * moving it and insert it again afterwards.
+ */
+typedef struct spatial_hash spatial_hash_t;
+
+/**
+ * Allocates an empty spatial hash.
+ * Cells about as large as the distances queried work best.
+ *
+ * @param cell_size the width and height of each cell
+ * @return the new spatial hash
+ */
+spatial_hash_t *spatial_hash_init(double cell_size);
+
+/**
+ * Releases a spatial hash. The bodies in it are not freed.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_free(spatial_hash_t *hash);
+
+/**
+ * Gets the number of bodies in a spatial hash.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ * @return the number of bodies inserted and not removed
+ */
+size_t spatial_hash_size(spatial_hash_t *hash);
+
+/**
+ * Takes every body out of a spatial hash, e.g. to refill it with bodies
+ * that have moved since it was filled. The bodies are not freed.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_clear(spatial_hash_t *hash);
+
+/**
+ * Files a body under the cell containing its centroid.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ * @param body the body to insert, which must not already be in the hash
+ */
+void spatial_hash_insert(spatial_hash_t *hash, body_t *body);
+
+/**
+ * Takes a body out of a spatial hash, e.g. before it is removed from
+ * its scene, so the hash never refers to a freed body.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ * @param body the body to remove
+ * @return whether the body was in the hash
+ */
+bool spatial_hash_remove(spatial_hash_t *hash, body_t *body);
+
+/**
+ * Finds the bodies whose bounds (see body_get_bounds()) come within
+ * a distance of a point, visiting only the cells that could hold them.
+ *
+ * @param hash a spatial hash returned from spatial_hash_init()
+ * @param center the point to search around
+ * @param radius the largest distance from center to a body's bounds
+ * @param results a list that the bodies found are appended to,
+ *   which must not own its elements
+ */
+void spatial_hash_query(spatial_hash_t *hash, vector_t center, double radius,
+                        list_t *results);
+
+#endif // #ifndef __SPATIAL_HASH_H__
@@ -1,6 +1,9 @@
 #ifndef __STATE_H__
 #define __STATE_H__
+#include "snapshot.h"
+#include "vector.h"
 #include <math.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -25,6 +28,36 @@ state_t *emscripten_init();
  */
 void emscripten_main(state_t *state);
 
+/**
+ * Advances the demo by one tick without drawing anything,
+ * so it can run on a different thread than the one drawing it.
+ * emscripten_main() calls this before drawing each frame.
+ * The tick makes no SDL input calls; the thread that owns the window
+ * reads the mouse and passes it in.
+ *
+ * @param mouse the mouse position in window coordinates (see get_mouse_pos())
+ */
+void emscripten_tick(state_t *state, vector_t mouse);
+
+/**
+ * Returns the (fixed) time each call to emscripten_tick() advances
+ * the demo by, in seconds.
+ */
+double emscripten_tick_length(void);
+
+/**
+ * Records what the demo should show after the last tick into a snapshot,
+ * which can then be drawn with snapshot_draw().
+ */
+void emscripten_snapshot(state_t *state, snapshot_t *snapshot);
+
+/**
+ * Returns whether the demo is showing a mostly static screen, like a menu,
+ * which is cheaper to draw with dirty rendering
+ * (see sdl_set_dirty_rendering()).
+ */
+bool emscripten_is_static(state_t *state);
+
 /**
  * Frees anything allocated in the demo
  * Should free everything in state as well as state itself.
@@ -8,14 +8,44 @@ typedef struct text {
   double width;
   color_t color;
   double duration;
-  list_t *texture;
   bool removed;
+  bool owns_text; // false if text points at a string that outlives it
+  size_t serial;  // unique to this text, never 0 (see body_get_serial())
 } text_t;
 
 text_t *text_init(char *text, vector_t center, double height, double width, color_t color, double duration);
 
 void text_edit(text_t *t, char *new);
 
+/**
+ * Shows a string the text doesn't own, such as a constant, without copying
+ * it. The string is not freed with the text, so it must outlive the text,
+ * or at least the next text_edit() or text_set_static().
+ *
+ * @param t the text to change
+ * @param text the string to show
+ */
+void text_set_static(text_t *t, const char *text);
+
+/**
+ * Allocates a text showing a number, with room for any number it is set to
+ * later, so it can be updated without allocating (see text_set_number()).
+ *
+ * @param number the number to show
+ * @return the new text, which text_free() releases like any other
+ */
+text_t *text_init_number(size_t number, vector_t center, double height, double width, color_t color, double duration);
+
+/**
+ * Shows a new number in a text made by text_init_number(),
+ * only writing the digits that differ from the ones shown.
+ *
+ * @param t a text returned from text_init_number()
+ * @param number the number to show
+ * @return whether any digit changed
+ */
+bool text_set_number(text_t *t, size_t number);
+
 void text_set_color(text_t *t, color_t new_color);
 
 void text_move(text_t *t, vector_t pos);
@@ -24,6 +54,14 @@ void text_render(text_t *t);
 
 void text_remove(text_t *t);
 
+/**
+ * Shows a text again, e.g. one that was removed when its duration ran out.
+ *
+ * @param t the text to show
+ * @param duration how long to show it for, in seconds
+ */
+void text_show(text_t *t, double duration);
+
 void text_tick(text_t *t, double dt);
 
 void text_free(void *t);
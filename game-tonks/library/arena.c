@@ -0,0 +1,317 @@
+#include "arena.h"
+#include "bot.h"
+#include "collision.h"
+#include "forces.h"
+#include "sdl_wrapper.h"
+#include "spatial_hash.h"
+#include "utils.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// slugs are dragged along by an applied force balanced by drag,
+// and their segments follow each other this far apart
+const double ARENA_SLUG_DRAG = 1000;
+const double ARENA_SEGMENT_SPACING = 12;
+// how hard a head is knocked off another slug's segment
+const double ARENA_BUMP_IMPULSE = 100;
+
+const double ARENA_WALL_THICKNESS = 10;
+const double ARENA_WALL_IMPULSE = 80000;
+const color_t ARENA_WALL_COLOR = {.r = 0.3, .g = 0.3, .b = 0.3, .a = 1};
+
+const double ARENA_FOOD_SIZE = 10;
+const double ARENA_FOOD_SPAWN_TIME = 5;
+// pellets are hashed into cells about as wide as a head can reach
+const double ARENA_FOOD_CELL_SIZE = 40;
+// how many random positions a pellet tries before it gives up spawning
+const size_t ARENA_FOOD_SPAWN_ATTEMPTS = 10;
+
+// the sides of the walls, used as the subtype of their tags
+typedef enum { WALL_TOP, WALL_BOTTOM, WALL_LEFT, WALL_RIGHT } wall_side_t;
+
+typedef struct arena {
+  scene_t *scene;
+  spatial_hash_t *food; // the pellets in the scene
+  // the players' segments, refilled each time a pellet spawns
+  spatial_hash_t *slugs;
+  list_t *players;      // indexed by their ids
+  list_t *bots;
+  vector_t min;
+  vector_t max;
+  double time_since_pellet; // seconds since a pellet last spawned
+  list_t *found; // the bodies found by the last query, reused by each query
+} arena_t;
+
+/** Pushes a head back into the arena, away from the wall it touched */
+void arena_wall_handler(body_t *head, body_t *wall, vector_t axis, void *aux) {
+  wall_side_t side = body_get_tag(wall).subtype;
+  if (side == WALL_TOP) {
+    body_add_impulse(head, (vector_t){.x = 0, .y = -ARENA_WALL_IMPULSE});
+  } else if (side == WALL_BOTTOM) {
+    body_add_impulse(head, (vector_t){.x = 0, .y = ARENA_WALL_IMPULSE});
+  } else if (side == WALL_LEFT) {
+    body_add_impulse(head, (vector_t){.x = ARENA_WALL_IMPULSE, .y = 0});
+  } else if (side == WALL_RIGHT) {
+    body_add_impulse(head, (vector_t){.x = -ARENA_WALL_IMPULSE, .y = 0});
+  }
+}
+
+/**
+ * Knocks a head sideways off another slug's segment and the segment along
+ * the head's path, unless either slug bumped into something just before
+ */
+void arena_bump_handler(body_t *head, body_t *segment, vector_t axis,
+                        void *aux) {
+  arena_t *arena = aux;
+  size_t head_id = body_get_tag(head).owner;
+  size_t segment_id = body_get_tag(segment).owner;
+  if (head_id == segment_id) {
+    return;
+  }
+  player_t *p1 = list_get(arena->players, head_id);
+  player_t *p2 = list_get(arena->players, segment_id);
+  if (p1->cd_collide_player > 0 || p2->cd_collide_player > 0) {
+    return;
+  }
+  vector_t head_velocity = body_get_velocity(head);
+  vector_t segment_velocity = body_get_velocity(segment);
+  vector_t impulse_on_head = vec_multiply(ARENA_BUMP_IMPULSE,
+                                          vec_perpendicular(segment_velocity));
+  if (fabs(vec_angle(impulse_on_head, head_velocity)) < M_PI / 2) {
+    impulse_on_head = vec_negate(impulse_on_head);
+  }
+  body_add_impulse(head, impulse_on_head);
+  body_add_impulse(segment, vec_multiply(ARENA_BUMP_IMPULSE, head_velocity));
+  player_refresh_cd_collide_player(p1);
+  player_refresh_cd_collide_player(p2);
+  sdl_play_sound(-1, "assets/collide.wav", 0);
+}
+
+void arena_bullet_handler(body_t *bullet, body_t *body, vector_t axis,
+                          void *aux) {
+  arena_t *arena = aux;
+  // bullets are swept, so the collision package has already found the hit;
+  // re-testing the current shapes would miss bullets that passed through.
+  // A bullet only hits one body a tick: parking it takes it out of the
+  // dispatch table for the rest of the tick. If its sweep crossed several
+  // bodies, that is whichever the dispatch reaches first (they are swept
+  // in order of their left edges), not necessarily the nearest along its
+  // path. Bullets only move a few pixels a tick, less than a segment is
+  // wide, so this rarely differs
+  size_t shooter_id = body_get_tag(bullet).owner;
+  size_t target_id = body_get_tag(body).owner;
+  if (body_in_categories(body, CATEGORY_WALL)) {
+    player_park_bullet(bullet);
+  } else if (target_id != shooter_id) {
+    player_hit(list_get(arena->players, shooter_id),
+               list_get(arena->players, target_id), body, arena->scene);
+    player_park_bullet(bullet);
+  }
+}
+
+void arena_add_wall(arena_t *arena, double width, double height,
+                    vector_t center, wall_side_t side) {
+  body_t *wall = body_init(make_rectangle(width, height, center), INFINITY,
+                           ARENA_WALL_COLOR);
+  body_set_tag(wall, (body_tag_t){.category = CATEGORY_WALL, .subtype = side});
+  scene_add_body(arena->scene, wall);
+}
+
+arena_t *arena_init(vector_t min, vector_t max) {
+  arena_t *arena = malloc(sizeof(arena_t));
+  assert(arena != NULL);
+  arena->scene = scene_init();
+  arena->food = spatial_hash_init(ARENA_FOOD_CELL_SIZE);
+  arena->slugs = spatial_hash_init(ARENA_FOOD_CELL_SIZE);
+  arena->players = list_init(1, player_free);
+  arena->bots = list_init(1, bot_free);
+  arena->min = min;
+  arena->max = max;
+  arena->time_since_pellet = 0;
+  arena->found = list_init(1, NULL);
+
+  double width = max.x - min.x;
+  double height = max.y - min.y;
+  vector_t center = vec_multiply(0.5, vec_add(min, max));
+  double offset = ARENA_WALL_THICKNESS / 2;
+  arena_add_wall(arena, ARENA_WALL_THICKNESS, height,
+                 (vector_t){min.x - offset, center.y}, WALL_LEFT);
+  arena_add_wall(arena, width, ARENA_WALL_THICKNESS,
+                 (vector_t){center.x, max.y + offset}, WALL_TOP);
+  arena_add_wall(arena, ARENA_WALL_THICKNESS, height,
+                 (vector_t){max.x + offset, center.y}, WALL_RIGHT);
+  arena_add_wall(arena, width, ARENA_WALL_THICKNESS,
+                 (vector_t){center.x, min.y - offset}, WALL_BOTTOM);
+
+  // collisions are dispatched by the categories of the bodies' tags,
+  // so bodies added later (segments, bullets) collide automatically;
+  // pellets don't move, so they are hashed once instead (see arena_eat)
+  scene_add_category_collision(arena->scene, CATEGORY_HEAD, CATEGORY_SEGMENT,
+                               arena_bump_handler, arena, NULL);
+  scene_add_category_collision(arena->scene, CATEGORY_HEAD, CATEGORY_WALL,
+                               arena_wall_handler, NULL, NULL);
+  scene_add_category_collision(arena->scene, CATEGORY_BULLET,
+                               CATEGORY_PLAYER | CATEGORY_WALL,
+                               arena_bullet_handler, arena, NULL);
+  return arena;
+}
+
+void arena_free(arena_t *arena) {
+  // the players' bodies and tags belong to the scene
+  list_free(arena->bots);
+  list_free(arena->players);
+  spatial_hash_free(arena->food);
+  spatial_hash_free(arena->slugs);
+  list_free(arena->found);
+  scene_free(arena->scene);
+  free(arena);
+}
+
+scene_t *arena_get_scene(arena_t *arena) { return arena->scene; }
+
+list_t *arena_get_players(arena_t *arena) { return arena->players; }
+
+void arena_add_player(arena_t *arena, player_t *player) {
+  assert(player->player_id == list_size(arena->players));
+  list_add(arena->players, player);
+  for (size_t i = 0; i < list_size(player->meta_bodies); i++) {
+    body_t *segment = list_get(player->meta_bodies, i);
+    scene_add_body(arena->scene, segment);
+    create_drag(arena->scene, ARENA_SLUG_DRAG, segment);
+    if (i == 0) {
+      // balances the drag at the slug's starting speed
+      *player->ph_applied_force_magnitude =
+          ARENA_SLUG_DRAG * vec_norm(body_get_velocity(segment));
+      create_applied_force(arena->scene, player->ph_applied_force_magnitude,
+                           segment);
+    } else {
+      create_follow_joint(arena->scene, ARENA_SEGMENT_SPACING, segment,
+                          list_get(player->meta_bodies, i - 1));
+    }
+  }
+  // the bullet pool stays in the scene, parked until it is fired
+  for (size_t i = 0; i < list_size(player->bullets); i++) {
+    scene_add_body(arena->scene, list_get(player->bullets, i));
+  }
+  scene_add_text(arena->scene, player->score_tag);
+  scene_add_text(arena->scene, player->buff_tag);
+  player_respawn(player, arena->scene);
+}
+
+void arena_add_bot(arena_t *arena) {
+  vector_t center = vec_multiply(0.5, vec_add(arena->min, arena->max));
+  player_t *player = player_init(list_size(arena->players), rand_color(1),
+                                 center, '\0', '\0', '\0', '\0');
+  arena_add_player(arena, player);
+  list_add(arena->bots, bot_init(player, arena->min, arena->max));
+}
+
+void arena_spawn_pellet(arena_t *arena) {
+  // look for a spot clear of the other pellets and the slugs, far enough
+  // inside the arena to miss the walls; a spot under a parked bullet is
+  // fine, since it is out of play. The slugs move, so they are hashed
+  // again for each spawn, and each try only looks at the cells around it
+  spatial_hash_clear(arena->slugs);
+  for (size_t i = 0; i < list_size(arena->players); i++) {
+    player_t *player = list_get(arena->players, i);
+    for (size_t j = 0; j < list_size(player->meta_bodies); j++) {
+      spatial_hash_insert(arena->slugs, list_get(player->meta_bodies, j));
+    }
+  }
+  vector_t position;
+  bool found_spot = false;
+  for (size_t i = 0; i < ARENA_FOOD_SPAWN_ATTEMPTS && !found_spot; i++) {
+    position = (vector_t){
+        .x = rand_range(arena->min.x + ARENA_FOOD_SIZE,
+                        arena->max.x - ARENA_FOOD_SIZE),
+        .y = rand_range(arena->min.y + ARENA_FOOD_SIZE,
+                        arena->max.y - ARENA_FOOD_SIZE)};
+    list_clear(arena->found);
+    spatial_hash_query(arena->food, position, ARENA_FOOD_SIZE, arena->found);
+    spatial_hash_query(arena->slugs, position, ARENA_FOOD_SIZE, arena->found);
+    found_spot = list_size(arena->found) == 0;
+  }
+  if (!found_spot) {
+    return;
+  }
+
+  powerup_t powerup = (powerup_t)(rand_range(0, 1) * PU_COUNT);
+  body_t *pellet = body_init_with_prototype(
+      prototype_get_round(6, ARENA_FOOD_SIZE), position, 1,
+      POWERUPS[powerup].color, NULL, NULL);
+  body_set_tag(pellet,
+               (body_tag_t){.category = CATEGORY_FOOD, .subtype = powerup});
+  body_set_glow(pellet, true);
+  body_set_glow_radius(pellet, ARENA_FOOD_SIZE);
+  scene_add_body(arena->scene, pellet);
+  spatial_hash_insert(arena->food, pellet);
+}
+
+/** Feeds a pellet to a player, which grows by a segment */
+void arena_eat_pellet(arena_t *arena, player_t *player, body_t *pellet) {
+  player_eat(player, pellet);
+  body_t *segment = player_add_body(player);
+  scene_add_body(arena->scene, segment);
+  create_drag(arena->scene, ARENA_SLUG_DRAG, segment);
+  size_t length = list_size(player->meta_bodies);
+  create_follow_joint(arena->scene, ARENA_SEGMENT_SPACING, segment,
+                      list_get(player->meta_bodies, length - 2));
+  spatial_hash_remove(arena->food, pellet);
+  body_remove(pellet);
+}
+
+/**
+ * Lets each head eat the pellets it touches,
+ * only testing the pellets hashed near it
+ */
+void arena_eat(arena_t *arena) {
+  for (size_t i = 0; i < list_size(arena->players); i++) {
+    player_t *player = list_get(arena->players, i);
+    body_t *head = player_get_head(player);
+    vector_t head_position = body_get_centroid(head);
+    double head_reach =
+        vec_norm(vec_subtract(body_get_bounds(head).max, head_position));
+    list_clear(arena->found);
+    spatial_hash_query(arena->food, head_position, head_reach, arena->found);
+    if (list_size(arena->found) > 0) {
+      list_t *head_points = body_get_shape(head);
+      for (size_t j = 0; j < list_size(arena->found); j++) {
+        body_t *pellet = list_get(arena->found, j);
+        list_t *pellet_points = body_get_shape(pellet);
+        if (find_collision(head_points, pellet_points).collided) {
+          arena_eat_pellet(arena, player, pellet);
+        }
+        list_free(pellet_points);
+      }
+      list_free(head_points);
+    }
+  }
+}
+
+void arena_tick(arena_t *arena, double dt) {
+  arena->time_since_pellet += dt;
+  if (arena->time_since_pellet >= ARENA_FOOD_SPAWN_TIME) {
+    arena->time_since_pellet = 0;
+    arena_spawn_pellet(arena);
+  }
+
+  for (size_t i = 0; i < list_size(arena->bots); i++) {
+    bot_tick(list_get(arena->bots, i), arena->players, arena->food, dt);
+  }
+  for (size_t i = 0; i < list_size(arena->players); i++) {
+    player_t *player = list_get(arena->players, i);
+    if (player_dying(player)) {
+      player_tick_death(player, arena->scene);
+    }
+    player_tick(player, dt);
+    player_turn(player);
+  }
+  scene_tick_canon(arena->scene, dt);
+  arena_eat(arena);
+
+  // moves the score tags along with the heads
+  for (size_t i = 0; i < list_size(arena->players); i++) {
+    player_update_stats(list_get(arena->players, i));
+  }
+}
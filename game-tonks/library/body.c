@@ -3,6 +3,7 @@
 #include "collision.h"
 #include "color.h"
 #include "polygon.h"
+#include "prototype.h"
 #include "sdl_wrapper.h"
 #include "vector.h"
 #include "utils.h"
@@ -17,48 +18,114 @@ const double DEV_MODE_VECTOR_THICKNESS = 1;
 color_t DEV_MODE_VEL_COLOR = (color_t){.r = 0, .g = 1, .b = 0, .a = 1};
 color_t DEV_MODE_ACL_COLOR = (color_t){.r = 1, .g = 0, .b = 0, .a = 1};
 
-const double GLOW_SCALE = 0.1;
-const size_t GLOW_FACTOR = 8;
-const double GLOW_REDUCTION = 0.8;
-const double GLOW_RESOLUTION = 10;
-const double GLOW_INCREASE = 3;
+// bodies slower than this are considered at rest
+const double BODY_SLEEP_SPEED = 1;
+const double BODY_SLEEP_ANGULAR_SPEED = 0.05;
+
+// the serial of the next body allocated; 0 is never a body's serial
+size_t next_body_serial = 1;
 
 typedef struct body {
   color_t color;
-  list_t *shape;
+  list_t *shape;          // NULL if the body's shape comes from a prototype
+  prototype_t *prototype; // shared shape placed at the centroid, or NULL
   vector_t pos; // position
   vector_t vel; // velocity
   vector_t acl; // acceleration
   double mass;
   vector_t centroid;
+  bounds_t bounds; // around the shape, relative to the centroid
   vector_t impulse;
   double angle;
+  double angular_vel;     // counterclockwise, in radians per second
+  double inertia;         // moment of inertia about the centroid
+  double torque;          // accumulated over the current tick
+  double angular_impulse; // accumulated over the current tick
   bool remove;
   bool glowing;
+  bool bullet;
+  vector_t sweep;    // centroid displacement over the last tick
+  uint32_t teleports; // times body_set_centroid() has moved the body
+  size_t serial;      // unique to this body, even after it is freed
+  bool asleep;
+  size_t still_ticks;   // consecutive ticks spent at rest
+  size_t island;        // scratch index used by the scene to build islands
+  body_handle_t handle; // where the body is in its scene
   void *info;
+  body_tag_t tag;
   double glow_radius;
   free_func_t info_freer;
 } body_t;
 
-body_t *body_init(list_t *shape, double mass, color_t color) {
+/**
+ * Recomputes the box around a body's shape, relative to its centroid.
+ * Prototypes are bounded by their radius, so their box doesn't change
+ * when they rotate.
+ */
+void update_bounds(body_t *body) {
+  if (body->prototype != NULL) {
+    double radius = prototype_get_radius(body->prototype);
+    body->bounds = (bounds_t){.min = {.x = -radius, .y = -radius},
+                              .max = {.x = radius, .y = radius}};
+    return;
+  }
+  body->bounds = (bounds_t){.min = {.x = INFINITY, .y = INFINITY},
+                            .max = {.x = -INFINITY, .y = -INFINITY}};
+  for (size_t i = 0; i < list_size(body->shape); i++) {
+    vector_t offset =
+        vec_subtract(*(vector_t *)list_get(body->shape, i), body->centroid);
+    body->bounds.min.x = fmin(body->bounds.min.x, offset.x);
+    body->bounds.min.y = fmin(body->bounds.min.y, offset.y);
+    body->bounds.max.x = fmax(body->bounds.max.x, offset.x);
+    body->bounds.max.y = fmax(body->bounds.max.y, offset.y);
+  }
+}
+
+/**
+ * Allocates a body at rest with either its own shape or a prototype,
+ * given its centroid and moment of inertia.
+ */
+body_t *body_alloc(list_t *shape, prototype_t *prototype, vector_t centroid,
+                   double inertia, double mass, color_t color) {
   body_t *new_body = malloc(sizeof(body_t));
+  assert(new_body != NULL);
   new_body->color = color;
   new_body->shape = shape;
+  new_body->prototype = prototype;
   new_body->pos = VEC_ZERO;
   new_body->vel = VEC_ZERO;
   new_body->acl = VEC_ZERO;
   new_body->impulse = VEC_ZERO;
   new_body->mass = mass;
-  new_body->centroid = polygon_centroid(shape);
+  new_body->centroid = centroid;
   new_body->angle = 0;
+  new_body->angular_vel = 0;
+  new_body->inertia = inertia;
+  new_body->torque = 0;
+  new_body->angular_impulse = 0;
   new_body->remove = false;
   new_body->info = NULL;
   new_body->info_freer = NULL;
+  new_body->tag = (body_tag_t){.category = 0, .owner = 0, .subtype = 0};
   new_body->glowing = false;
   new_body->glow_radius = 0;
+  new_body->bullet = false;
+  new_body->sweep = VEC_ZERO;
+  new_body->teleports = 0;
+  new_body->serial = next_body_serial++;
+  new_body->asleep = false;
+  new_body->still_ticks = 0;
+  new_body->island = 0;
+  new_body->handle = (body_handle_t){.index = 0, .generation = 0};
+  update_bounds(new_body);
   return new_body;
 }
 
+body_t *body_init(list_t *shape, double mass, color_t color) {
+  return body_alloc(shape, NULL, polygon_centroid(shape), INFINITY, mass,
+                    color);
+}
+
 body_t *body_init_with_info(list_t *shape, double mass, color_t color,
                             void *info, free_func_t info_freer) {
   body_t *body = body_init(shape, mass, color);
@@ -67,9 +134,20 @@ body_t *body_init_with_info(list_t *shape, double mass, color_t color,
   return body;
 }
 
+body_t *body_init_with_prototype(prototype_t *prototype, vector_t centroid,
+                                 double mass, color_t color, void *info,
+                                 free_func_t info_freer) {
+  body_t *body = body_alloc(NULL, prototype, centroid, INFINITY, mass, color);
+  body->info = info;
+  body->info_freer = info_freer;
+  return body;
+}
+
 void body_free(void *body) {
   body_t *body_casted = (body_t *)body;
-  list_free(body_casted->shape);
+  if (body_casted->shape != NULL) {
+    list_free(body_casted->shape);
+  }
   if (body_casted->info_freer != NULL) {
     body_casted->info_freer(body_casted->info);
   }
@@ -78,7 +156,22 @@ void body_free(void *body) {
 
 void *body_get_info(body_t *body) { return body->info; }
 
+body_tag_t body_get_tag(body_t *body) { return body->tag; }
+
+void body_set_tag(body_t *body, body_tag_t tag) { body->tag = tag; }
+
+uint32_t body_get_category(body_t *body) { return body->tag.category; }
+
+bool body_in_categories(body_t *body, uint32_t categories) {
+  return (body->tag.category & categories) != 0;
+}
+
+prototype_t *body_get_prototype(body_t *body) { return body->prototype; }
+
 list_t *body_get_shape(body_t *body) {
+  if (body->prototype != NULL) {
+    return prototype_place(body->prototype, body->centroid, body->angle);
+  }
   list_t *new_body = list_init(list_size(body->shape), free);
   list_t *body_pts = body->shape;
   for (size_t i = 0; i < list_size(body_pts); i++) {
@@ -93,6 +186,11 @@ list_t *body_get_shape(body_t *body) {
 
 double body_get_mass(body_t *body) { return body->mass; }
 
+bounds_t body_get_bounds(body_t *body) {
+  return (bounds_t){.min = vec_add(body->centroid, body->bounds.min),
+                    .max = vec_add(body->centroid, body->bounds.max)};
+}
+
 vector_t body_get_centroid(body_t *body) { return body->centroid; }
 
 vector_t body_get_position(body_t *body) { return body->pos; }
@@ -101,7 +199,12 @@ void body_set_position(body_t *body, vector_t pos) { body->pos = pos; }
 
 vector_t body_get_velocity(body_t *body) { return body->vel; }
 
-void body_set_velocity(body_t *body, vector_t v) { body->vel = v; }
+void body_set_velocity(body_t *body, vector_t v) {
+  body->vel = v;
+  if (!vec_equals(v, VEC_ZERO)) {
+    body_wake(body);
+  }
+}
 
 vector_t body_get_acceleration(body_t *body) { return body->acl; }
 
@@ -111,25 +214,93 @@ void body_set_acceleration(body_t *body, vector_t new_acl) {
 
 color_t body_get_color(body_t *body) { return body->color; }
 
+/**
+ * Moves the vertices of a body that owns its shape;
+ * a prototype's shape follows the centroid on its own.
+ */
+void translate_shape(body_t *body, vector_t dx) {
+  if (body->shape != NULL) {
+    polygon_translate(body->shape, dx);
+  }
+}
+
 void body_set_centroid(body_t *body, vector_t x) {
   vector_t dx = vec_subtract(x, body->centroid);
-  polygon_translate(body->shape, dx);
+  translate_shape(body, dx);
   body->centroid = x;
+  body->sweep = VEC_ZERO;
+  body->teleports++;
+  body_wake(body);
+}
+
+void body_translate(body_t *body, vector_t dx) {
+  translate_shape(body, dx);
+  body->pos = vec_add(body->pos, dx);
+  body->centroid = vec_add(body->centroid, dx);
+  body->sweep = vec_add(body->sweep, dx);
 }
 
 void body_set_color(body_t *body, color_t color) { body->color = color; }
 
 void body_set_rotation(body_t *body, double angle) {
-  polygon_rotate(body->shape, angle - body->angle, body->centroid);
+  if (body->shape != NULL) {
+    polygon_rotate(body->shape, angle - body->angle, body->centroid);
+    update_bounds(body);
+  }
   body->angle = angle;
 }
 
+double body_get_rotation(body_t *body) { return body->angle; }
+
+double body_get_inertia(body_t *body) { return body->inertia; }
+
+void body_enable_rotation(body_t *body) {
+  assert(body->mass != INFINITY);
+  body->inertia = body->prototype != NULL
+                      ? prototype_get_inertia(body->prototype, body->mass)
+                      : polygon_moment_of_inertia(body->shape, body->mass);
+}
+
+void body_set_inertia(body_t *body, double inertia) {
+  assert(inertia > 0);
+  body->inertia = inertia;
+  if (inertia == INFINITY) {
+    body->angular_vel = 0;
+  }
+}
+
+double body_get_angular_velocity(body_t *body) { return body->angular_vel; }
+
+void body_set_angular_velocity(body_t *body, double omega) {
+  body->angular_vel = body->inertia == INFINITY ? 0 : omega;
+  if (body->angular_vel != 0) {
+    body_wake(body);
+  }
+}
+
 void body_add_force(body_t *body, vector_t force) {
   vector_t a = body_get_acceleration(body);
   vector_t da = vec_multiply(1.0 / body_get_mass(body), force);
   body_set_acceleration(body, vec_add(a, da));
+  if (body->mass != INFINITY && !vec_equals(force, VEC_ZERO)) {
+    body_wake(body);
+  }
 }
 
+void body_add_force_at(body_t *body, vector_t force, vector_t point) {
+  body_add_force(body, force);
+  body_add_torque(body, vec_cross(vec_subtract(point, body->centroid), force));
+}
+
+void body_add_torque(body_t *body, double torque) {
+  body->torque += torque;
+  if (body->inertia != INFINITY && torque != 0) {
+    body_wake(body);
+  }
+}
+
+double body_get_torque(body_t *body) { return body->torque; }
+
 list_t *vector_pts(vector_t start, vector_t acl) {
   vector_t end = vec_add(start, acl);
   list_t *pts = list_init(4, free);
@@ -167,7 +338,72 @@ void body_draw_acl(body_t *body) {
   }
 }
 
+/** Velocity of the point of a body at offset r from its centroid */
+vector_t point_velocity(vector_t vel, double angular_vel, vector_t r) {
+  return vec_add(vel, (vector_t){-angular_vel * r.y, angular_vel * r.x});
+}
+
+/**
+ * Gets a body's shape for reading, without copying it if the body owns it.
+ * Must be handed back with release_shape().
+ */
+list_t *borrow_shape(body_t *body) {
+  return body->shape != NULL ? body->shape : body_get_shape(body);
+}
+
+void release_shape(body_t *body, list_t *shape) {
+  if (shape != body->shape) {
+    list_free(shape);
+  }
+}
+
+/**
+ * Elastic impulse for bodies that can rotate,
+ * applied at the point where they touch.
+ */
+void add_elastic_impulse_at_contact(body_t *body1, body_t *body2,
+                                    double elasticity, vector_t axis) {
+  list_t *shape1 = borrow_shape(body1);
+  list_t *shape2 = borrow_shape(body2);
+  vector_t contact = find_contact_point(shape1, shape2, axis);
+  release_shape(body1, shape1);
+  release_shape(body2, shape2);
+  vector_t r1 = vec_subtract(contact, body1->centroid);
+  vector_t r2 = vec_subtract(contact, body2->centroid);
+  double inv_mass1 = body1->mass == INFINITY ? 0 : 1.0 / body1->mass;
+  double inv_mass2 = body2->mass == INFINITY ? 0 : 1.0 / body2->mass;
+  double inv_inertia1 = body1->inertia == INFINITY ? 0 : 1.0 / body1->inertia;
+  double inv_inertia2 = body2->inertia == INFINITY ? 0 : 1.0 / body2->inertia;
+  double rn1 = vec_cross(r1, axis);
+  double rn2 = vec_cross(r2, axis);
+  double k = inv_mass1 + inv_mass2 + inv_inertia1 * rn1 * rn1 +
+             inv_inertia2 * rn2 * rn2;
+
+  vector_t v1 = point_velocity(body1->vel, body1->angular_vel, r1);
+  vector_t v2 = point_velocity(body2->vel, body2->angular_vel, r2);
+  double impulse_scalar =
+      (1 + elasticity) * vec_dot(vec_subtract(v2, v1), axis) / k;
+  vector_t impulse = vec_multiply(impulse_scalar, axis);
+  body_add_impulse_at(body1, impulse, contact);
+  body_add_impulse_at(body2, vec_negate(impulse), contact);
+}
+
 void body_add_elastic_impulse(body_t *body1, body_t *body2, double elasticity) {
+  list_t *shape1 = borrow_shape(body1);
+  list_t *shape2 = borrow_shape(body2);
+  vector_t collision_axis = find_collision(shape1, shape2).axis;
+  release_shape(body1, shape1);
+  release_shape(body2, shape2);
+  vector_t centroid_diff =
+      vec_subtract(body_get_centroid(body2), body_get_centroid(body1));
+  if (vec_dot(collision_axis, centroid_diff) < 0) {
+    collision_axis = vec_negate(collision_axis);
+  }
+  if (body1->inertia != INFINITY || body2->inertia != INFINITY) {
+    add_elastic_impulse_at_contact(body1, body2, elasticity, collision_axis);
+    return;
+  }
+
   double reduced_mass;
   if (body1->mass == INFINITY) {
     reduced_mass = body2->mass;
@@ -176,12 +412,6 @@ void body_add_elastic_impulse(body_t *body1, body_t *body2, double elasticity) {
   } else {
     reduced_mass = (body1->mass * body2->mass) / (body1->mass + body2->mass);
   }
-  vector_t collision_axis = find_collision(body1->shape, body2->shape).axis;
-  vector_t centroid_diff =
-      vec_subtract(body_get_centroid(body2), body_get_centroid(body1));
-  if (vec_dot(collision_axis, centroid_diff) < 0) {
-    collision_axis = vec_negate(collision_axis);
-  }
   double u_a = vec_dot(body1->vel, collision_axis);
   double u_b = vec_dot(body2->vel, collision_axis);
   double c_r = elasticity;
@@ -195,6 +425,88 @@ void body_add_elastic_impulse(body_t *body1, body_t *body2, double elasticity) {
 
 void body_add_impulse(body_t *body, vector_t impulse) {
   body->impulse = vec_add(body->impulse, impulse);
+  if (body->mass != INFINITY && !vec_equals(impulse, VEC_ZERO)) {
+    body_wake(body);
+  }
+}
+
+vector_t body_get_impulse(body_t *body) { return body->impulse; }
+
+void body_add_impulse_at(body_t *body, vector_t impulse, vector_t point) {
+  body_add_impulse(body, impulse);
+  body_add_angular_impulse(
+      body, vec_cross(vec_subtract(point, body->centroid), impulse));
+}
+
+void body_add_angular_impulse(body_t *body, double impulse) {
+  body->angular_impulse += impulse;
+  if (body->inertia != INFINITY && impulse != 0) {
+    body_wake(body);
+  }
+}
+
+double body_get_angular_impulse(body_t *body) {
+  return body->angular_impulse;
+}
+
+void body_set_bullet(body_t *body, bool bullet) { body->bullet = bullet; }
+
+bool body_is_bullet(body_t *body) { return body->bullet; }
+
+vector_t body_get_sweep(body_t *body) { return body->sweep; }
+
+uint32_t body_get_teleports(body_t *body) { return body->teleports; }
+
+size_t body_get_serial(body_t *body) { return body->serial; }
+
+bool body_is_asleep(body_t *body) { return body->asleep; }
+
+void body_sleep(body_t *body) {
+  body->asleep = true;
+  body->vel = VEC_ZERO;
+  body->acl = VEC_ZERO;
+  body->impulse = VEC_ZERO;
+  body->angular_vel = 0;
+  body->torque = 0;
+  body->angular_impulse = 0;
+  body->sweep = VEC_ZERO;
+}
+
+void body_wake(body_t *body) {
+  if (body->asleep) {
+    body->asleep = false;
+    body->still_ticks = 0;
+  }
+}
+
+void body_wake_pair(body_t *body1, body_t *body2) {
+  if (body1->mass != INFINITY) {
+    body_wake(body1);
+  }
+  if (body2->mass != INFINITY) {
+    body_wake(body2);
+  }
+}
+
+void body_update_still_ticks(body_t *body) {
+  if (vec_dot(body->vel, body->vel) < BODY_SLEEP_SPEED * BODY_SLEEP_SPEED &&
+      fabs(body->angular_vel) < BODY_SLEEP_ANGULAR_SPEED) {
+    body->still_ticks++;
+  } else {
+    body->still_ticks = 0;
+  }
+}
+
+size_t body_get_still_ticks(body_t *body) { return body->still_ticks; }
+
+size_t body_get_island(body_t *body) { return body->island; }
+
+void body_set_island(body_t *body, size_t island) { body->island = island; }
+
+body_handle_t body_get_handle(body_t *body) { return body->handle; }
+
+void body_set_handle(body_t *body, body_handle_t handle) {
+  body->handle = handle;
 }
 
 bool body_get_glow(body_t *body) {
@@ -214,14 +526,31 @@ void body_set_glow_radius(body_t *body, double glow_radius) {
 }
 
 void body_draw_glow(body_t *body, double radius) {
-  color_t glow_color = body_get_color(body);
-  glow_color.a = GLOW_SCALE * body_get_color(body).a; 
-  for (size_t j = 0; j < GLOW_FACTOR; j++) { 
-    glow_color.a = GLOW_REDUCTION * glow_color.a;
-    list_t *glow_circle = make_circle(GLOW_RESOLUTION, radius + GLOW_INCREASE*j, body_get_centroid(body)); 
-    sdl_draw_polygon(glow_circle, glow_color);
-    list_free(glow_circle);
+  sdl_draw_glow(body_get_centroid(body), radius, body_get_color(body));
+}
+
+/**
+ * Updates a body's angular velocity from the torques and angular impulses
+ * applied during the tick, and rotates it. Resets the angular impulse;
+ * the torque is reset by the caller along with the acceleration.
+ * Bodies with infinite inertia, or that aren't spinning, are left untouched
+ * so they never pay for rotating their vertices.
+ *
+ * @param average whether to rotate at the average of the old and new angular
+ *   velocities (as in body_tick()) instead of the new one
+ */
+void body_tick_rotation(body_t *body, double dt, bool average) {
+  if (body->inertia != INFINITY) {
+    double old_vel = body->angular_vel;
+    double new_vel = old_vel + (dt * body->torque + body->angular_impulse) /
+                                   body->inertia;
+    body->angular_vel = new_vel;
+    double angle_change = dt * (average ? 0.5 * (old_vel + new_vel) : new_vel);
+    if (angle_change != 0) {
+      body_set_rotation(body, body->angle + angle_change);
+    }
   }
+  body->angular_impulse = 0;
 }
 
 void body_tick(body_t *body, double dt) {
@@ -236,9 +565,12 @@ void body_tick(body_t *body, double dt) {
   vector_t pos_change = vec_multiply(dt, avg_vel);
   body->pos = vec_add(body->pos, pos_change);
   body->centroid = vec_add(body->centroid, pos_change);
-  polygon_translate(body->shape, pos_change);
+  translate_shape(body, pos_change);
+  body->sweep = pos_change;
   body_set_acceleration(body, VEC_ZERO);
   body->impulse = VEC_ZERO;
+  body_tick_rotation(body, dt, true);
+  body->torque = 0;
 }
 
 void body_tick_canon(body_t *body, double dt) {
@@ -252,9 +584,12 @@ void body_tick_canon(body_t *body, double dt) {
   vector_t pos_change = vec_multiply(dt, new_vel);
   body->pos = vec_add(body->pos, pos_change);
   body->centroid = vec_add(body->centroid, pos_change);
-  polygon_translate(body->shape, pos_change);
+  translate_shape(body, pos_change);
+  body->sweep = pos_change;
   body_set_acceleration(body, VEC_ZERO);
   body->impulse = VEC_ZERO;
+  body_tick_rotation(body, dt, false);
+  body->torque = 0;
 }
 
 void body_tick_canon_no_reset(body_t *body, double dt) {
@@ -268,8 +603,10 @@ void body_tick_canon_no_reset(body_t *body, double dt) {
   vector_t pos_change = vec_multiply(dt, new_vel);
   body->pos = vec_add(body->pos, pos_change);
   body->centroid = vec_add(body->centroid, pos_change);
-  polygon_translate(body->shape, pos_change);
+  translate_shape(body, pos_change);
+  body->sweep = pos_change;
   body->impulse = VEC_ZERO;
+  body_tick_rotation(body, dt, false);
 }
 
 void body_remove(body_t *body) { body->remove = true; }
@@ -0,0 +1,160 @@
+#include "bot.h"
+#include "utils.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// seconds between a bot's decisions
+const double BOT_THINK_INTERVAL = 0.2;
+// how far away a bot can see pellets
+const double BOT_SIGHT_RADIUS = 300;
+// how close to a wall a bot gets before it turns back
+const double BOT_WALL_MARGIN = 80;
+// how close a bot gets to where it is wandering before picking somewhere else
+const double BOT_ARRIVE_DISTANCE = 50;
+// how far off its heading the target can be before the bot turns, in radians
+const double BOT_STEER_TOLERANCE = 0.1;
+// how far away and how far off its heading a head can be to get shot
+const double BOT_SHOOT_RANGE = 400;
+const double BOT_AIM_ANGLE = 0.15;
+// how far away and how straight ahead the target must be to dash for it
+const double BOT_DASH_DISTANCE = 250;
+const double BOT_DASH_ANGLE = 0.2;
+
+typedef struct bot {
+  player_t *player;
+  vector_t arena_min;
+  vector_t arena_max;
+  vector_t target;    // where the bot is heading
+  double think_timer; // seconds until the bot looks around again
+  list_t *seen;       // the pellets found by the last look around
+} bot_t;
+
+/** A random point in the arena, away from the walls */
+vector_t bot_random_target(bot_t *bot) {
+  return (vector_t){
+      .x = rand_range(bot->arena_min.x + BOT_WALL_MARGIN,
+                      bot->arena_max.x - BOT_WALL_MARGIN),
+      .y = rand_range(bot->arena_min.y + BOT_WALL_MARGIN,
+                      bot->arena_max.y - BOT_WALL_MARGIN)};
+}
+
+bot_t *bot_init(player_t *player, vector_t arena_min, vector_t arena_max) {
+  bot_t *bot = malloc(sizeof(bot_t));
+  assert(bot != NULL);
+  bot->player = player;
+  bot->arena_min = arena_min;
+  bot->arena_max = arena_max;
+  bot->target = bot_random_target(bot);
+  // stagger the bots so they don't all think on the same tick
+  bot->think_timer = rand_range(0, BOT_THINK_INTERVAL);
+  bot->seen = list_init(1, NULL);
+  return bot;
+}
+
+void bot_free(void *bot) {
+  list_free(((bot_t *)bot)->seen);
+  free(bot);
+}
+
+player_t *bot_get_player(bot_t *bot) { return bot->player; }
+
+/**
+ * The angle to turn a heading by to face a point, in radians;
+ * positive angles are counterclockwise (a left turn)
+ */
+double bot_bearing(vector_t position, vector_t heading, vector_t point) {
+  vector_t to_point = vec_subtract(point, position);
+  return atan2(vec_cross(heading, to_point), vec_dot(heading, to_point));
+}
+
+/** The nearest pellet within sight of a point, or NULL if there is none */
+body_t *bot_find_food(bot_t *bot, spatial_hash_t *food, vector_t position) {
+  list_clear(bot->seen);
+  spatial_hash_query(food, position, BOT_SIGHT_RADIUS, bot->seen);
+  body_t *nearest = NULL;
+  double nearest_distance = INFINITY;
+  for (size_t i = 0; i < list_size(bot->seen); i++) {
+    body_t *pellet = list_get(bot->seen, i);
+    double distance = vec_dist(position, body_get_centroid(pellet));
+    if (distance < nearest_distance) {
+      nearest = pellet;
+      nearest_distance = distance;
+    }
+  }
+  return nearest;
+}
+
+/** Whether a head is close to a wall and moving towards it */
+bool bot_near_wall(bot_t *bot, vector_t position, vector_t heading) {
+  return (position.x < bot->arena_min.x + BOT_WALL_MARGIN && heading.x < 0) ||
+         (position.x > bot->arena_max.x - BOT_WALL_MARGIN && heading.x > 0) ||
+         (position.y < bot->arena_min.y + BOT_WALL_MARGIN && heading.y < 0) ||
+         (position.y > bot->arena_max.y - BOT_WALL_MARGIN && heading.y > 0);
+}
+
+/** Whether another live player's head is in range and in front of the bot */
+bool bot_has_shot(bot_t *bot, list_t *players, vector_t position,
+                  vector_t heading) {
+  for (size_t i = 0; i < list_size(players); i++) {
+    player_t *other = list_get(players, i);
+    if (other == bot->player || player_dying(other)) {
+      continue;
+    }
+    vector_t other_position = player_head_pos(other);
+    if (vec_dist(position, other_position) <= BOT_SHOOT_RANGE &&
+        fabs(bot_bearing(position, heading, other_position)) < BOT_AIM_ANGLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Picks where to head next, and dashes or shoots if it is worth it */
+void bot_think(bot_t *bot, list_t *players, spatial_hash_t *food,
+               vector_t position, vector_t heading) {
+  player_t *player = bot->player;
+  if (bot_near_wall(bot, position, heading)) {
+    bot->target = bot_random_target(bot);
+  } else {
+    body_t *pellet = bot_find_food(bot, food, position);
+    if (pellet != NULL) {
+      bot->target = body_get_centroid(pellet);
+    } else if (vec_dist(position, bot->target) < BOT_ARRIVE_DISTANCE) {
+      bot->target = bot_random_target(bot);
+    }
+  }
+
+  double bearing = bot_bearing(position, heading, bot->target);
+  if (player->cd_dash == 0 && fabs(bearing) < BOT_DASH_ANGLE &&
+      vec_dist(position, bot->target) > BOT_DASH_DISTANCE) {
+    player_dash(player);
+  }
+  if (player->cd_shoot == 0 &&
+      bot_has_shot(bot, players, position, heading)) {
+    player_shoot(player);
+  }
+}
+
+void bot_tick(bot_t *bot, list_t *players, spatial_hash_t *food, double dt) {
+  player_t *player = bot->player;
+  if (player_dying(player)) {
+    player->turn_left = false;
+    player->turn_right = false;
+    return;
+  }
+  body_t *head = player_get_head(player);
+  vector_t position = body_get_centroid(head);
+  vector_t heading = body_get_velocity(head);
+
+  bot->think_timer -= dt;
+  if (bot->think_timer <= 0) {
+    bot->think_timer += BOT_THINK_INTERVAL;
+    bot_think(bot, players, food, position, heading);
+  }
+
+  // steer towards the target every tick, like holding down a key
+  double bearing = bot_bearing(position, heading, bot->target);
+  player->turn_left = bearing > BOT_STEER_TOLERANCE;
+  player->turn_right = bearing < -BOT_STEER_TOLERANCE;
+}
@@ -5,6 +5,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// how much better the second shape's face must fit the collision axis
+// to be used as the reference face, so the choice doesn't flicker
+const double REFERENCE_FACE_BIAS = 1e-3;
+// contact points this close to the deepest one are averaged together
+const double CONTACT_POINT_TOLERANCE = 0.05;
+
 // Returns a list of lines perpendicular to the edges of both shapes
 list_t *get_perpendicular_lines(list_t *shape1, list_t *shape2) {
   list_t *perpendicular_lines =
@@ -124,6 +130,240 @@ collision_info_t find_collision(list_t *shape1, list_t *shape2) {
   }
   collision_data.collided = true;
   collision_data.axis = collision_axis;
+  collision_data.depth = smallest_overlap;
+  list_free(perpendicular_lines);
+  return collision_data;
+}
+
+collision_info_t find_collision_with_margin(list_t *shape1, list_t *shape2,
+                                            double margin) {
+  list_t *perpendicular_lines = get_perpendicular_lines(shape1, shape2);
+  collision_info_t collision_data = {.collided = false};
+  double smallest_overlap = INFINITY;
+  vector_t collision_axis = VEC_ZERO;
+  for (size_t i = 0; i < list_size(perpendicular_lines); i++) {
+    vector_t axis = *((vector_t *)list_get(perpendicular_lines, i));
+    vector_t endpoints1 = project_shape(shape1, axis);
+    vector_t endpoints2 = project_shape(shape2, axis);
+    // negative if there is a gap between the projections
+    double overlap = fmin(endpoints2.y - endpoints1.x,
+                          endpoints1.y - endpoints2.x);
+    if (overlap < -margin) {
+      list_free(perpendicular_lines);
+      return collision_data;
+    }
+    if (overlap < smallest_overlap) {
+      smallest_overlap = overlap;
+      collision_axis = axis;
+    }
+  }
+  collision_data.collided = true;
+  collision_data.axis = collision_axis;
+  collision_data.depth = smallest_overlap;
   list_free(perpendicular_lines);
   return collision_data;
 }
+
+/**
+ * Returns the convex hull of 'points' in counterclockwise order
+ * (Andrew's monotone chain). Sorts 'points' in place.
+ */
+static list_t *convex_hull(vector_t *points, size_t n) {
+  // insertion sort by x, then y; hulls here only have a few dozen points
+  for (size_t i = 1; i < n; i++) {
+    vector_t p = points[i];
+    size_t j = i;
+    while (j > 0 && (points[j - 1].x > p.x ||
+                     (points[j - 1].x == p.x && points[j - 1].y > p.y))) {
+      points[j] = points[j - 1];
+      j--;
+    }
+    points[j] = p;
+  }
+
+  vector_t *hull = malloc(sizeof(vector_t) * 2 * n);
+  size_t k = 0;
+  // lower hull
+  for (size_t i = 0; i < n; i++) {
+    while (k >= 2 && vec_cross(vec_subtract(hull[k - 1], hull[k - 2]),
+                               vec_subtract(points[i], hull[k - 2])) <= 0) {
+      k--;
+    }
+    hull[k++] = points[i];
+  }
+  // upper hull
+  size_t lower_size = k + 1;
+  for (size_t i = n - 1; i > 0; i--) {
+    while (k >= lower_size &&
+           vec_cross(vec_subtract(hull[k - 1], hull[k - 2]),
+                     vec_subtract(points[i - 1], hull[k - 2])) <= 0) {
+      k--;
+    }
+    hull[k++] = points[i - 1];
+  }
+  // the last point is the same as the first one
+  k--;
+
+  list_t *hull_list = list_init(k, free);
+  for (size_t i = 0; i < k; i++) {
+    vector_t *v = malloc(sizeof(vector_t));
+    *v = hull[i];
+    list_add(hull_list, v);
+  }
+  free(hull);
+  return hull_list;
+}
+
+collision_info_t find_swept_collision(list_t *shape1, vector_t sweep1,
+                                      list_t *shape2) {
+  if (vec_equals(sweep1, VEC_ZERO)) {
+    return find_collision(shape1, shape2);
+  }
+
+  // the swept region is the hull of the shape at the start and end of the tick
+  size_t n = list_size(shape1);
+  vector_t *points = malloc(sizeof(vector_t) * 2 * n);
+  for (size_t i = 0; i < n; i++) {
+    vector_t v = *((vector_t *)list_get(shape1, i));
+    points[i] = v;
+    points[n + i] = vec_subtract(v, sweep1);
+  }
+  list_t *swept_shape = convex_hull(points, 2 * n);
+  free(points);
+
+  collision_info_t collision_data = find_collision(swept_shape, shape2);
+  list_free(swept_shape);
+  return collision_data;
+}
+
+/**
+ * Finds the edge of a shape whose outward normal points furthest along
+ * a direction, and returns the index of its first vertex.
+ * Assumes the shape's vertices are in counterclockwise order.
+ */
+size_t find_face(list_t *shape, vector_t direction, vector_t *normal) {
+  size_t n = list_size(shape);
+  size_t best = 0;
+  double best_alignment = -INFINITY;
+  for (size_t i = 0; i < n; i++) {
+    vector_t v1 = *((vector_t *)list_get(shape, i));
+    vector_t v2 = *((vector_t *)list_get(shape, (i + 1) % n));
+    vector_t edge_normal = vec_normalize(vec_perpendicular(vec_subtract(v2, v1)));
+    double alignment = vec_dot(edge_normal, direction);
+    if (alignment > best_alignment) {
+      best_alignment = alignment;
+      best = i;
+      *normal = edge_normal;
+    }
+  }
+  return best;
+}
+
+/** Clips the segment from p to q to the slab lo <= dot(x, tangent) <= hi */
+bool clip_segment(vector_t *p, vector_t *q, vector_t tangent, double lo,
+                  double hi) {
+  double sp = vec_dot(*p, tangent);
+  double sq = vec_dot(*q, tangent);
+  if (fmax(sp, sq) < lo || fmin(sp, sq) > hi) {
+    return false;
+  }
+  vector_t start = *p;
+  vector_t delta = vec_subtract(*q, *p);
+  double ds = sq - sp;
+  if (ds != 0) {
+    double t0 = fmax(0, fmin((lo - sp) / ds, (hi - sp) / ds));
+    double t1 = fmin(1, fmax((lo - sp) / ds, (hi - sp) / ds));
+    *p = vec_add(start, vec_multiply(t0, delta));
+    *q = vec_add(start, vec_multiply(t1, delta));
+  }
+  return true;
+}
+
+/**
+ * The points where two colliding convex polygons touch.
+ * Two shapes resting face to face touch at two points (the ends of the
+ * overlapping part of their edges); otherwise they touch at one.
+ */
+typedef struct {
+  size_t count;
+  vector_t points[2]; // halfway between the two shapes
+  double depths[2];   // negative if there is a gap at the point
+} contact_manifold_t;
+
+/**
+ * Clips the incident edge against the reference face (see
+ * find_contact_point()) and keeps the clipped points within margin
+ * of the deepest one.
+ */
+contact_manifold_t find_contact_manifold(list_t *shape1, list_t *shape2,
+                                         vector_t axis, double margin) {
+  // the reference face is whichever face lies flattest against the axis;
+  // the incident face of the other shape is clipped against it
+  vector_t normal1, normal2;
+  size_t face1 = find_face(shape1, axis, &normal1);
+  size_t face2 = find_face(shape2, vec_negate(axis), &normal2);
+  bool flip = vec_dot(normal2, vec_negate(axis)) >
+              vec_dot(normal1, axis) + REFERENCE_FACE_BIAS;
+  list_t *reference = flip ? shape2 : shape1;
+  list_t *incident = flip ? shape1 : shape2;
+  size_t ref_face = flip ? face2 : face1;
+  size_t inc_face = flip ? face1 : face2;
+  vector_t ref_normal = flip ? normal2 : normal1;
+
+  vector_t r1 = *((vector_t *)list_get(reference, ref_face));
+  vector_t r2 = *((vector_t *)list_get(
+      reference, (ref_face + 1) % list_size(reference)));
+  vector_t p = *((vector_t *)list_get(incident, inc_face));
+  vector_t q = *((vector_t *)list_get(
+      incident, (inc_face + 1) % list_size(incident)));
+
+  contact_manifold_t manifold = {.count = 0};
+  vector_t tangent = vec_normalize(vec_subtract(r2, r1));
+  if (clip_segment(&p, &q, tangent, vec_dot(r1, tangent),
+                   vec_dot(r2, tangent))) {
+    vector_t clipped[2] = {p, q};
+    // negative if the point is inside the reference shape
+    double separations[2] = {vec_dot(vec_subtract(p, r1), ref_normal),
+                             vec_dot(vec_subtract(q, r1), ref_normal)};
+    double deepest = fmin(separations[0], separations[1]);
+    for (size_t i = 0; i < 2; i++) {
+      double separation = separations[i];
+      if (separation <= deepest + margin) {
+        // halfway between the two shapes
+        manifold.points[manifold.count] =
+            vec_subtract(clipped[i], vec_multiply(0.5 * separation, ref_normal));
+        manifold.depths[manifold.count] = -separation;
+        manifold.count++;
+      }
+    }
+    if (manifold.count == 2 && vec_equals(p, q)) {
+      manifold.count = 1;
+    }
+  }
+  if (manifold.count == 0) {
+    // corner to corner: fall back on the incident shape's deepest vertex
+    double deepest = INFINITY;
+    for (size_t i = 0; i < list_size(incident); i++) {
+      vector_t v = *((vector_t *)list_get(incident, i));
+      double separation = vec_dot(vec_subtract(v, r1), ref_normal);
+      if (separation < deepest) {
+        deepest = separation;
+        manifold.points[0] =
+            vec_subtract(v, vec_multiply(0.5 * separation, ref_normal));
+      }
+    }
+    manifold.depths[0] = -deepest;
+    manifold.count = 1;
+  }
+  return manifold;
+}
+
+vector_t find_contact_point(list_t *shape1, list_t *shape2, vector_t axis) {
+  contact_manifold_t manifold =
+      find_contact_manifold(shape1, shape2, axis, CONTACT_POINT_TOLERANCE);
+  vector_t point = VEC_ZERO;
+  for (size_t i = 0; i < manifold.count; i++) {
+    point = vec_add(point, manifold.points[i]);
+  }
+  return vec_multiply(1.0 / manifold.count, point);
+}
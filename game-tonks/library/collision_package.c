@@ -1,5 +1,6 @@
 #include "collision_package.h"
 #include "collision.h"
+#include <math.h>
 
 collision_package_t *collision_package_init(body_t *body1, body_t *body2,
                                             collision_handler_t handler,
@@ -13,19 +14,43 @@ collision_package_t *collision_package_init(body_t *body1, body_t *body2,
   return package;
 }
 
-void collision_package_handle(collision_package_t *pkg) {
-  body_t *body1 = pkg->body1;
-  body_t *body2 = pkg->body2;
+/**
+ * Tests two bodies for a collision.
+ * If either body is a bullet, its shape is swept over its motion
+ * relative to the other body during the last tick.
+ */
+collision_info_t collision_package_test(body_t *body1, body_t *body2,
+                                        list_t *shape1, list_t *shape2) {
+  vector_t relative_sweep =
+      vec_subtract(body_get_sweep(body1), body_get_sweep(body2));
+  if (body_is_bullet(body1)) {
+    return find_swept_collision(shape1, relative_sweep, shape2);
+  } else if (body_is_bullet(body2)) {
+    collision_info_t info =
+        find_swept_collision(shape2, vec_negate(relative_sweep), shape1);
+    info.axis = vec_negate(info.axis);
+    return info;
+  }
+  return find_collision(shape1, shape2);
+}
+
+void collision_handle_bodies(body_t *body1, body_t *body2,
+                             collision_handler_t handler, void *aux) {
   list_t *shape1 = body_get_shape(body1);
   list_t *shape2 = body_get_shape(body2);
-  if (find_collision(shape1, shape2).collided) {
-    vector_t axis = find_collision(shape1, shape2).axis;
-    pkg->handler(body1, body2, axis, pkg->aux);
+  collision_info_t info = collision_package_test(body1, body2, shape1, shape2);
+  if (info.collided) {
+    body_wake_pair(body1, body2);
+    handler(body1, body2, info.axis, aux);
   }
   list_free(shape1);
   list_free(shape2);
 }
 
+void collision_package_handle(collision_package_t *pkg) {
+  collision_handle_bodies(pkg->body1, pkg->body2, pkg->handler, pkg->aux);
+}
+
 void collision_package_free(void *pkg) {
   collision_package_t *pkg_casted = (collision_package_t *)pkg;
   if (pkg_casted->freer != NULL) {
@@ -0,0 +1,115 @@
+#include "constraint.h"
+
+#include "body.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct constraint {
+  body_t *body1;
+  body_t *body2;
+  double min_length;
+  double max_length;
+  double compliance;
+  bool one_way;
+  double lambda; // accumulated Lagrange multiplier for this tick
+  bool removed;
+} constraint_t;
+
+constraint_t *constraint_init(body_t *body1, body_t *body2, double min_length,
+                              double max_length, double compliance) {
+  assert(body_get_mass(body1) != INFINITY || body_get_mass(body2) != INFINITY);
+  assert(0 <= min_length && min_length <= max_length);
+  assert(compliance >= 0);
+  constraint_t *constraint = malloc(sizeof(constraint_t));
+  assert(constraint != NULL);
+  constraint->body1 = body1;
+  constraint->body2 = body2;
+  constraint->min_length = min_length;
+  constraint->max_length = max_length;
+  constraint->compliance = compliance;
+  constraint->one_way = false;
+  constraint->lambda = 0;
+  constraint->removed = false;
+  return constraint;
+}
+
+void constraint_set_one_way(constraint_t *constraint, bool one_way) {
+  constraint->one_way = one_way;
+}
+
+body_t *constraint_get_body1(constraint_t *constraint) {
+  return constraint->body1;
+}
+
+body_t *constraint_get_body2(constraint_t *constraint) {
+  return constraint->body2;
+}
+
+bool constraint_has_body(constraint_t *constraint, body_t *body) {
+  return constraint->body1 == body || constraint->body2 == body;
+}
+
+void constraint_remove(constraint_t *constraint) {
+  constraint->removed = true;
+}
+
+bool constraint_is_removed(constraint_t *constraint) {
+  return constraint->removed;
+}
+
+void constraint_reset(constraint_t *constraint) { constraint->lambda = 0; }
+
+/** Moves a body by a position correction and adds it to its velocity */
+void apply_position_correction(body_t *body, vector_t correction, double dt) {
+  body_translate(body, correction);
+  body_set_velocity(body, vec_add(body_get_velocity(body),
+                                  vec_multiply(1.0 / dt, correction)));
+}
+
+void constraint_solve(constraint_t *constraint, double dt) {
+  body_t *body1 = constraint->body1;
+  body_t *body2 = constraint->body2;
+  vector_t diff =
+      vec_subtract(body_get_centroid(body2), body_get_centroid(body1));
+  double length = vec_norm(diff);
+  if (length == 0) {
+    // no direction to push the bodies apart in
+    return;
+  }
+
+  double error;
+  if (length < constraint->min_length) {
+    error = length - constraint->min_length;
+  } else if (length > constraint->max_length) {
+    error = length - constraint->max_length;
+  } else {
+    return;
+  }
+
+  double mass1 = body_get_mass(body1);
+  double mass2 = body_get_mass(body2);
+  double w1 = mass1 == INFINITY ? 0 : 1.0 / mass1;
+  double w2 = (constraint->one_way || mass2 == INFINITY) ? 0 : 1.0 / mass2;
+  double alpha = constraint->compliance / (dt * dt);
+  if (w1 + w2 + alpha == 0) {
+    return;
+  }
+
+  double delta_lambda =
+      (-error - alpha * constraint->lambda) / (w1 + w2 + alpha);
+  constraint->lambda += delta_lambda;
+
+  // the gradient of the error is -n for body1 and n for body2
+  vector_t n = vec_multiply(1.0 / length, diff);
+  if (w1 != 0) {
+    apply_position_correction(body1, vec_multiply(-w1 * delta_lambda, n), dt);
+  }
+  if (w2 != 0) {
+    apply_position_correction(body2, vec_multiply(w2 * delta_lambda, n), dt);
+  }
+}
+
+void constraint_free(void *constraint) { free(constraint); }
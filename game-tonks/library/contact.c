@@ -0,0 +1,218 @@
+#include "contact.h"
+
+#include "body.h"
+#include "collision.h"
+#include "list.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// fraction of the penetration removed each tick (Baumgarte stabilization)
+const double CONTACT_BAUMGARTE = 0.2;
+// penetration allowed before position correction kicks in
+const double CONTACT_SLOP = 0.5;
+// approach speed below which contacts don't bounce, so resting bodies settle
+const double CONTACT_RESTITUTION_THRESHOLD = 10;
+// gap within which separated bodies are still solved as touching
+const double CONTACT_MARGIN = 0.25;
+
+typedef struct contact {
+  body_t *body1;
+  body_t *body2;
+  double elasticity;
+  bool touching;
+  double dt;
+  vector_t normal; // unit vector pointing from body1 towards body2
+  double inv_mass1;
+  double inv_mass2;
+  double inv_inertia1; // 0 for bodies that can't rotate
+  double inv_inertia2;
+  vector_t r1; // contact point relative to body1's centroid
+  vector_t r2; // contact point relative to body2's centroid
+  double normal_mass; // effective mass along the normal at the contact point
+  double bias;        // target separating speed
+  double accumulated_impulse;
+  bool removed;
+} contact_t;
+
+double inverse_mass(body_t *body) {
+  double mass = body_get_mass(body);
+  return mass == INFINITY ? 0 : 1.0 / mass;
+}
+
+double inverse_inertia(body_t *body) {
+  double inertia = body_get_inertia(body);
+  return inertia == INFINITY ? 0 : 1.0 / inertia;
+}
+
+contact_t *contact_init(body_t *body1, body_t *body2, double elasticity) {
+  assert(body_get_mass(body1) != INFINITY || body_get_mass(body2) != INFINITY);
+  contact_t *contact = malloc(sizeof(contact_t));
+  assert(contact != NULL);
+  contact->body1 = body1;
+  contact->body2 = body2;
+  contact->elasticity = elasticity;
+  contact->touching = false;
+  contact->dt = 0;
+  contact->normal = VEC_ZERO;
+  contact->inv_mass1 = inverse_mass(body1);
+  contact->inv_mass2 = inverse_mass(body2);
+  contact->inv_inertia1 = 0;
+  contact->inv_inertia2 = 0;
+  contact->r1 = VEC_ZERO;
+  contact->r2 = VEC_ZERO;
+  contact->normal_mass = 1.0 / (contact->inv_mass1 + contact->inv_mass2);
+  contact->bias = 0;
+  contact->accumulated_impulse = 0;
+  contact->removed = false;
+  return contact;
+}
+
+body_t *contact_get_body1(contact_t *contact) { return contact->body1; }
+
+body_t *contact_get_body2(contact_t *contact) { return contact->body2; }
+
+bool contact_is_touching(contact_t *contact) { return contact->touching; }
+
+double contact_get_impulse(contact_t *contact) {
+  return contact->accumulated_impulse;
+}
+
+bool contact_has_body(contact_t *contact, body_t *body) {
+  return contact->body1 == body || contact->body2 == body;
+}
+
+/**
+ * Computes the velocity a point of a body will have at the end of the tick,
+ * given the forces and torques applied to it so far, and its impulses if
+ * with_impulses is set. r is the point's offset from the body's centroid.
+ */
+vector_t predicted_velocity(body_t *body, double inv_mass, double inv_inertia,
+                            vector_t r, double dt, bool with_impulses) {
+  vector_t vel = vec_add(body_get_velocity(body),
+                         vec_multiply(dt, body_get_acceleration(body)));
+  if (with_impulses) {
+    vel = vec_add(vel, vec_multiply(inv_mass, body_get_impulse(body)));
+  }
+  if (inv_inertia == 0) {
+    return vel;
+  }
+  double angular_change = dt * body_get_torque(body);
+  if (with_impulses) {
+    angular_change += body_get_angular_impulse(body);
+  }
+  double omega = body_get_angular_velocity(body) + inv_inertia * angular_change;
+  return vec_add(vel, (vector_t){-omega * r.y, omega * r.x});
+}
+
+/**
+ * Relative velocity of body2 with respect to body1 along the normal.
+ * Without impulses, this is how fast the bodies approach before any contact
+ * (including warm starting) has pushed them this tick.
+ */
+double normal_velocity(contact_t *contact, bool with_impulses) {
+  vector_t v1 = predicted_velocity(contact->body1, contact->inv_mass1,
+                                   contact->inv_inertia1, contact->r1,
+                                   contact->dt, with_impulses);
+  vector_t v2 = predicted_velocity(contact->body2, contact->inv_mass2,
+                                   contact->inv_inertia2, contact->r2,
+                                   contact->dt, with_impulses);
+  return vec_dot(vec_subtract(v2, v1), contact->normal);
+}
+
+void apply_normal_impulse(contact_t *contact, double impulse) {
+  vector_t p = vec_multiply(impulse, contact->normal);
+  body_add_impulse(contact->body1, vec_negate(p));
+  body_add_impulse(contact->body2, p);
+  if (contact->inv_inertia1 != 0) {
+    body_add_angular_impulse(contact->body1, -vec_cross(contact->r1, p));
+  }
+  if (contact->inv_inertia2 != 0) {
+    body_add_angular_impulse(contact->body2, vec_cross(contact->r2, p));
+  }
+}
+
+void contact_prepare(contact_t *contact, double dt) {
+  contact->dt = dt;
+  contact->touching = false;
+  if (body_is_removed(contact->body1) || body_is_removed(contact->body2)) {
+    contact->accumulated_impulse = 0;
+    return;
+  }
+
+  list_t *shape1 = body_get_shape(contact->body1);
+  list_t *shape2 = body_get_shape(contact->body2);
+  collision_info_t info =
+      find_collision_with_margin(shape1, shape2, CONTACT_MARGIN);
+  if (!info.collided) {
+    list_free(shape1);
+    list_free(shape2);
+    contact->accumulated_impulse = 0;
+    return;
+  }
+
+  vector_t normal = info.axis;
+  vector_t centroid_diff = vec_subtract(body_get_centroid(contact->body2),
+                                        body_get_centroid(contact->body1));
+  if (vec_dot(normal, centroid_diff) < 0) {
+    normal = vec_negate(normal);
+  }
+  contact->normal = normal;
+  contact->touching = true;
+
+  // only bodies that can rotate care where along the normal they are pushed
+  contact->inv_inertia1 = inverse_inertia(contact->body1);
+  contact->inv_inertia2 = inverse_inertia(contact->body2);
+  if (contact->inv_inertia1 != 0 || contact->inv_inertia2 != 0) {
+    vector_t point = find_contact_point(shape1, shape2, normal);
+    contact->r1 = vec_subtract(point, body_get_centroid(contact->body1));
+    contact->r2 = vec_subtract(point, body_get_centroid(contact->body2));
+    double rn1 = vec_cross(contact->r1, normal);
+    double rn2 = vec_cross(contact->r2, normal);
+    contact->normal_mass =
+        1.0 / (contact->inv_mass1 + contact->inv_mass2 +
+               contact->inv_inertia1 * rn1 * rn1 +
+               contact->inv_inertia2 * rn2 * rn2);
+  }
+  list_free(shape1);
+  list_free(shape2);
+
+  if (info.depth < 0) {
+    // there is still a gap: only let the bodies close it during this tick
+    contact->bias = info.depth / dt;
+  } else {
+    // position correction: push the bodies apart over the next few ticks
+    double penetration = fmax(info.depth - CONTACT_SLOP, 0);
+    double correction = CONTACT_BAUMGARTE / dt * penetration;
+    // restitution: bounce back a fraction of the approach speed
+    double approach = normal_velocity(contact, false);
+    double bounce = approach < -CONTACT_RESTITUTION_THRESHOLD
+                        ? -contact->elasticity * approach
+                        : 0;
+    contact->bias = fmax(correction, bounce);
+  }
+
+  // warm start with last tick's impulse, along the current normal
+  apply_normal_impulse(contact, contact->accumulated_impulse);
+}
+
+void contact_solve(contact_t *contact) {
+  if (!contact->touching) {
+    return;
+  }
+  double vn = normal_velocity(contact, true);
+  double impulse = contact->normal_mass * (contact->bias - vn);
+
+  // the accumulated impulse may only push the bodies apart
+  double old_impulse = contact->accumulated_impulse;
+  contact->accumulated_impulse = fmax(old_impulse + impulse, 0);
+  apply_normal_impulse(contact, contact->accumulated_impulse - old_impulse);
+}
+
+void contact_remove(contact_t *contact) { contact->removed = true; }
+
+bool contact_is_removed(contact_t *contact) { return contact->removed; }
+
+void contact_free(void *contact) { free(contact); }
@@ -1,10 +1,16 @@
 #include "math.h"
 #include "sdl_wrapper.h"
+#include "snapshot.h"
 #include "state.h"
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #endif
 
 state_t *state;
@@ -29,13 +35,149 @@ void loop() {
   }
 }
 
+#ifndef __EMSCRIPTEN__
+// If the physics thread falls further behind than this (in seconds),
+// it gives up on catching up instead of ticking as fast as it can
+const double MAX_TICK_LAG = 0.25;
+
+/**
+ * The snapshots passed from the physics thread to the render thread.
+ * The physics thread records each tick into `recording` and publishes it
+ * by swapping it with `ready`. The render thread draws between `previous`
+ * and `current`, and moves `ready` into `current` when a new one is published.
+ * Only the swaps happen under snapshot_lock, so neither thread waits
+ * for the other to record or draw a snapshot.
+ */
+snapshot_t *recording;
+snapshot_t *ready;
+snapshot_t *previous;
+snapshot_t *current;
+bool ready_is_new = false;
+pthread_mutex_t snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+/**
+ * Held while the state is ticked or handles input events.
+ */
+pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+/**
+ * Where the mouse was when the render thread last polled for events.
+ * SDL's input functions may only be called from the thread that owns the
+ * window, so the physics thread ticks with this instead.
+ * Guarded by state_lock.
+ */
+vector_t mouse;
+/**
+ * Set by the render thread once the window is closed.
+ */
+atomic_bool quitting = false;
+
+/** The time on a monotonic clock, in seconds */
+double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/** Ticks the state at a fixed rate and publishes a snapshot after each tick */
+void *physics_loop(void *aux) {
+  double tick_length = emscripten_tick_length();
+  double next_tick = now();
+  while (!atomic_load(&quitting)) {
+    pthread_mutex_lock(&state_lock);
+    emscripten_tick(state, mouse);
+    snapshot_clear(recording, next_tick);
+    emscripten_snapshot(state, recording);
+    pthread_mutex_unlock(&state_lock);
+
+    pthread_mutex_lock(&snapshot_lock);
+    snapshot_t *published = ready;
+    ready = recording;
+    recording = published;
+    ready_is_new = true;
+    pthread_mutex_unlock(&snapshot_lock);
+
+    next_tick += tick_length;
+    double wait = next_tick - now();
+    if (wait > 0) {
+      struct timespec sleep = {.tv_sec = (time_t)wait,
+                               .tv_nsec = (wait - (time_t)wait) * 1e9};
+      nanosleep(&sleep, NULL);
+    } else if (wait < -MAX_TICK_LAG) {
+      next_tick = now();
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Runs the demo natively: the state is ticked on a physics thread
+ * while this thread, which owns the window, draws the snapshots it publishes.
+ * Each frame is drawn one tick in the past, interpolating between the two
+ * snapshots around that time, so motion stays smooth even though the display
+ * and the physics run at different rates.
+ */
+void run_threaded(void) {
+  state = emscripten_init();
+  recording = snapshot_init();
+  ready = snapshot_init();
+  previous = snapshot_init();
+  current = snapshot_init();
+  snapshot_clear(current, now());
+  emscripten_snapshot(state, current);
+  mouse = get_mouse_pos();
+
+  pthread_t physics_thread;
+  int created = pthread_create(&physics_thread, NULL, physics_loop, NULL);
+  assert(created == 0);
+
+  double tick_length = emscripten_tick_length();
+  while (true) {
+    pthread_mutex_lock(&snapshot_lock);
+    if (ready_is_new) {
+      snapshot_t *oldest = previous;
+      previous = current;
+      current = ready;
+      ready = oldest;
+      ready_is_new = false;
+    }
+    pthread_mutex_unlock(&snapshot_lock);
+
+    double render_time = now() - tick_length;
+    double span = snapshot_get_time(current) - snapshot_get_time(previous);
+    double alpha =
+        span > 0 ? (render_time - snapshot_get_time(previous)) / span : 1;
+    alpha = fmin(fmax(alpha, 0), 1);
+
+    pthread_mutex_lock(&state_lock);
+    sdl_set_dirty_rendering(emscripten_is_static(state));
+    pthread_mutex_unlock(&state_lock);
+    sdl_begin_frame();
+    snapshot_draw(previous, current, alpha);
+    sdl_end_frame();
+
+    pthread_mutex_lock(&state_lock);
+    bool done = sdl_is_done(state);
+    mouse = get_mouse_pos();
+    pthread_mutex_unlock(&state_lock);
+    if (done) {
+      break;
+    }
+  }
+
+  atomic_store(&quitting, true);
+  pthread_join(physics_thread, NULL);
+  snapshot_free(recording);
+  snapshot_free(ready);
+  snapshot_free(previous);
+  snapshot_free(current);
+  emscripten_free(state);
+}
+#endif
+
 int main() {
 #ifdef __EMSCRIPTEN__
   // Set loop as the function emscripten calls to request a new frame
   emscripten_set_main_loop_arg(loop, NULL, 0, 1);
 #else
-  while (1) {
-    loop();
-  }
+  run_threaded();
 #endif
 }
@@ -11,6 +11,7 @@ typedef struct force_wrapper {
   force_creator_t force_creator;
   void *aux;
   bool remove;
+  bool collision;
   free_func_t freer;
   list_t *bodies;
 } force_wrapper_t;
@@ -21,6 +22,7 @@ force_wrapper_t *force_init(force_creator_t force_creator, void *aux,
   force->force_creator = force_creator;
   force->aux = aux;
   force->remove = false;
+  force->collision = false;
   force->freer = freer;
   force->bodies = NULL;
   return force;
@@ -36,6 +38,12 @@ force_wrapper_t *force_init_with_bodies(force_creator_t force_creator,
 
 list_t *force_get_bodies(force_wrapper_t *f) { return f->bodies; }
 
+void force_set_collision(force_wrapper_t *f, bool collision) {
+  f->collision = collision;
+}
+
+bool force_is_collision(force_wrapper_t *f) { return f->collision; }
+
 void force_create(force_wrapper_t *f) { f->force_creator(f->aux); }
 
 void *force_get_aux(force_wrapper_t *force) { return force->aux; }
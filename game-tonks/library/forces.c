@@ -3,6 +3,8 @@
 #include "body.h"
 #include "collision.h"
 #include "collision_package.h"
+#include "constraint.h"
+#include "contact.h"
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -78,6 +80,23 @@ void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
   scene_add_bodies_force_creator(scene, s_creator, s_aux, bodies, aux_free);
 }
 
+void create_distance_joint(scene_t *scene, double length, body_t *body1,
+                           body_t *body2) {
+  scene_add_constraint(scene, constraint_init(body1, body2, length, length, 0));
+}
+
+void create_rope_joint(scene_t *scene, double max_length, body_t *body1,
+                       body_t *body2) {
+  scene_add_constraint(scene, constraint_init(body1, body2, 0, max_length, 0));
+}
+
+void create_follow_joint(scene_t *scene, double length, body_t *follower,
+                         body_t *leader) {
+  constraint_t *joint = constraint_init(follower, leader, length, length, 0);
+  constraint_set_one_way(joint, true);
+  scene_add_constraint(scene, joint);
+}
+
 void drag_force_creator(void *aux) {
   aux_t *aux_casted = (aux_t *)aux;
   double gamma = *((double *)list_get(aux_get_constants(aux_casted), 0));
@@ -148,7 +167,7 @@ void create_destructive_collision(scene_t *scene, body_t *body1,
   list_add(bodies, body2);
 
   aux_t *aux = aux_init(NULL, bodies);
-  scene_add_bodies_force_creator(scene, creator, aux, bodies, aux_free);
+  scene_add_bodies_collision_creator(scene, creator, aux, bodies, aux_free);
 }
 
 void general_collision_handler(void *pkg) {
@@ -167,50 +186,11 @@ void create_collision(scene_t *scene, body_t *body1, body_t *body2,
   list_add(bodies, body1);
   list_add(bodies, body2);
 
-  scene_add_bodies_force_creator(scene, collision_handler, pkg, bodies,
-                                 collision_package_free);
-}
-
-void normal_collision_handler(body_t *body1, body_t *body2, vector_t axis,
-                              void *aux) {
-  list_t *info = (list_t *)aux;
-  bool *impulsed_last_tick = list_get(info, 0);
-  double *elasticity = list_get(info, 1);
-
-  list_t *shape1 = body_get_shape(body1);
-  list_t *shape2 = body_get_shape(body2);
-
-  if (find_collision(shape1, shape2).collided && !(*impulsed_last_tick)) {
-    *impulsed_last_tick = true;
-    body_add_elastic_impulse(body1, body2, *elasticity);
-  } else {
-    *impulsed_last_tick = false;
-  }
-  list_free(shape1);
-  list_free(shape2);
+  scene_add_bodies_collision_creator(scene, collision_handler, pkg, bodies,
+                                     collision_package_free);
 }
 
 void create_physics_collision(scene_t *scene, double elasticity, body_t *body1,
                               body_t *body2) {
-
-  force_creator_t handler = general_collision_handler;
-  list_t *info = list_init(2, NULL);
-
-  bool *impulsed_last_tick = malloc(sizeof(bool));
-  *impulsed_last_tick = false;
-  list_add(info, impulsed_last_tick);
-
-  double *e = malloc(sizeof(double));
-  *e = elasticity;
-  list_add(info, e);
-
-  collision_package_t *pkg = collision_package_init(
-      body1, body2, normal_collision_handler, info, NULL); // CHECK FREER
-
-  list_t *bodies = list_init(2, NULL);
-  list_add(bodies, body1);
-  list_add(bodies, body2);
-
-  scene_add_bodies_force_creator(scene, handler, pkg, bodies,
-                                 collision_package_free);
-}
\ No newline at end of file
+  scene_add_contact(scene, contact_init(body1, body2, elasticity));
+}
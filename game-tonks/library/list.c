@@ -76,4 +76,26 @@ void list_free(void *list) {
   free(list);
 }
 
+void list_clear(list_t *list) {
+  if (list->freer != NULL) {
+    for (size_t i = 0; i < list->size; i++) {
+      list->freer(list->data[i]);
+    }
+  }
+  list->size = 0;
+}
+
+void list_remove_if(list_t *list, bool (*removed)(void *)) {
+  size_t kept = 0;
+  for (size_t i = 0; i < list->size; i++) {
+    void *element = list->data[i];
+    if (!removed(element)) {
+      list->data[kept++] = element;
+    } else if (list->freer != NULL) {
+      list->freer(element);
+    }
+  }
+  list->size = kept;
+}
+
 size_t list_size(list_t *list) { return list->size; }
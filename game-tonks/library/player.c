@@ -1,10 +1,7 @@
 #include "player.h"
+#include <assert.h>
 
 // constants
-const double DEFAULT_BASE_SPEED = 100;
-const double DEFAULT_BULLET_SPEED = 200;
-const double DEFAULT_TURN_RATE = 0.02;
-const double DEFAULT_DASH_BOOST = 200;
 const double DEFAULT_DASH_CD = 1.24;
 const double DEFAULT_PLAYER_COLLIDE_CD = 0.1;
 const double DEFAULT_BULLET_CD = 1;
@@ -12,17 +9,16 @@ const double BULLET_SPAWN_DISTANCE = 15;
 const double BULLET_SIZE = 7;
 const double BULLET_RESOLUTION = 10;
 const double BULLET_MASS = 1;
-const size_t INFO_MAX_LENGTH = 20;
+const size_t BULLET_POOL_SIZE = 8;
+const double BULLET_LIFETIME = 8;
+// where bullets out of play wait, outside the window
+const vector_t BULLET_PARKING_POSITION = (vector_t){-1000, -1000};
 const double BUFF_SIZE_WIDTH = 15;
 const double BUFF_SIZE_HEIGHT = 20;
+const double BUFF_DURATION = 1;
 const size_t CRITICAL_BODIES = 5;
 const double INTENSITY_REDUCTION = 0.01;
 
-const double SPEED_PU = 30;
-const double ROT_PU = 0.008;
-const double BULLET_SPEED_PU = 30;
-const double DASH_PU = 150;
-
 const double APPLIED_FORCE_SCALE = 1000.0;
 
 const double CD_COLLISION_INITIAL = 3;
@@ -34,7 +30,6 @@ const double SLUG_SEGMENT_SIZE = 8;
 const size_t SLUG_INIT_SEGMENTS = 5;
 const double SLUG_MASS = 100;
 const double SLUG_RESOLUTION = 20;
-const double SLUG_GLOW_RESOLUTION = 10;
 const double STARTING_SCORE = 0;
 
 const double SCORE_KILL = 100;
@@ -54,55 +49,59 @@ const vector_t SPAWNBOX_MAX = (vector_t){1400, 700};
 
 const double INNER_GLOW_ALPHA = 0.3;
 
-// Creates a circle
-list_t *make_round_shape(size_t num_points, double radius, vector_t center)
+powerup_info_t POWERUPS[PU_COUNT] = {
+    [PU_BASE_SPEED] = {.color = {.r = 0.3, .g = 1, .b = 1, .a = 1}, .sound = "assets/pu_base_speed.wav", .text = "+MS  ", .base = 100, .boost = 30, .sound_id = SIZE_MAX},
+    [PU_BULLET_SPEED] = {.color = {.r = 0.5, .g = 0.1, .b = 1, .a = 1}, .sound = "assets/pu_bullet_speed.wav", .text = "+BMS ", .base = 200, .boost = 30, .sound_id = SIZE_MAX},
+    [PU_ROTATE_RATE] = {.color = {.r = 1, .g = 0, .b = 0.9, .a = 1}, .sound = "assets/pu_rotate_rate.wav", .text = "+ROT ", .base = 0.02, .boost = 0.008, .sound_id = SIZE_MAX},
+    [PU_DASH_BOOST] = {.color = {.r = 1, .g = 0.9, .b = 0, .a = 1}, .sound = "assets/pu_dash_boost.wav", .text = "+DASH", .base = 200, .boost = 150, .sound_id = SIZE_MAX}};
+
+void powerups_load_sounds(void)
 {
-  list_t *circle = list_init(num_points, free);
-  double x_pos, y_pos;
-  double increment_angle = 2 * M_PI / num_points;
-  double angle = 0;
-  for (size_t i = 0; i < num_points; i++)
+  for (size_t i = 0; i < PU_COUNT; i++)
   {
-    x_pos = cos(angle) * radius + center.x;
-    y_pos = sin(angle) * radius + center.y;
-    vector_t *point = malloc(sizeof(vector_t));
-    point->x = x_pos;
-    point->y = y_pos;
-    list_add(circle, point);
-    angle += increment_angle;
+    POWERUPS[i].sound_id = sdl_load_sound(POWERUPS[i].sound);
   }
-  return circle;
 }
 
 player_t *player_init(size_t player_id, color_t color, vector_t pos, char left_key, char right_key, char boost_key, char shoot_key)
 {
   // make segments
-  list_t *meta_bodies = list_init(SLUG_INIT_SEGMENTS, free);
+  list_t *meta_bodies = list_init(SLUG_INIT_SEGMENTS, NULL);
   vector_t circ_pos = pos;
   for (size_t i = 0; i < SLUG_INIT_SEGMENTS; i++)
   {
-    list_t *curr_circle = make_round_shape(SLUG_RESOLUTION, SLUG_SEGMENT_SIZE, circ_pos);
-    list_t *info = list_init(2, free);
-    char *body_type = malloc(sizeof(char) * INFO_MAX_LENGTH);
-    body_type = "player";
-    size_t *id = malloc(sizeof(size_t));
-    *id = player_id;
-    list_add(info, body_type);
-    list_add(info, id);
-    body_t *curr_body = body_init_with_info(curr_circle, SLUG_MASS, color, info, free);
-    double x_init_vel = rand_range(0, DEFAULT_BASE_SPEED);
-    double y_init_vel = sqrt(pow(DEFAULT_BASE_SPEED, 2) - (pow(x_init_vel, 2)));
+    prototype_t *segment = prototype_get_round(SLUG_RESOLUTION, SLUG_SEGMENT_SIZE);
+    body_t *curr_body = body_init_with_prototype(segment, circ_pos, SLUG_MASS, color, NULL, NULL);
+    body_set_tag(curr_body, (body_tag_t){.category = i == 0 ? CATEGORY_HEAD : CATEGORY_SEGMENT, .owner = player_id, .subtype = i});
+    double base_speed = POWERUPS[PU_BASE_SPEED].base;
+    double x_init_vel = rand_range(0, base_speed);
+    double y_init_vel = sqrt(pow(base_speed, 2) - (pow(x_init_vel, 2)));
     body_set_velocity(curr_body, (vector_t){.x = x_init_vel, .y = y_init_vel});
     body_set_glow(curr_body, true);
     body_set_glow_radius(curr_body, SLUG_SEGMENT_SIZE);
     list_add(meta_bodies, curr_body);
   }
 
+  // make the bullet pool
+  list_t *bullets = list_init(BULLET_POOL_SIZE, NULL);
+  for (size_t i = 0; i < BULLET_POOL_SIZE; i++)
+  {
+    prototype_t *bullet_shape = prototype_get_round(BULLET_RESOLUTION, BULLET_SIZE);
+    body_t *bullet = body_init_with_prototype(bullet_shape, BULLET_PARKING_POSITION, BULLET_MASS, color, NULL, NULL);
+    body_set_tag(bullet, (body_tag_t){.owner = player_id});
+    body_set_bullet(bullet, true);
+    player_park_bullet(bullet);
+    list_add(bullets, bullet);
+  }
+
   // init player
   player_t *player = malloc(sizeof(player_t));
 
   player->player_id = player_id;
   player->meta_bodies = meta_bodies;
+  player->bullets = bullets;
+  player->bullet_ages = calloc(BULLET_POOL_SIZE, sizeof(double));
+  player->next_bullet = 0;
   player->dying = false;
 
   player->ph_applied_force_magnitude = malloc(sizeof(double));
@@ -126,37 +125,25 @@ player_t *player_init(size_t player_id, color_t color, vector_t pos, char left_k
   player->cd_shoot = CD_SHOOT_INITIAL;
   player->cd_collide_player = CD_COLLISION_INITIAL;
 
-  player->pu_base_speed = 0;
-  player->pu_rotate_rate = 0;
-  player->pu_bullet_speed = 0;
-  player->pu_dash_boost = 0;
+  for (size_t i = 0; i < PU_COUNT; i++)
+  {
+    player->pu_counts[i] = 0;
+  }
 
   vector_t center = body_get_centroid(player_get_head(player));
-  char *score_tag_text = player_get_score(player);
-  player->score_tag = text_init(score_tag_text, center, STATS_SIZE_HEIGHT, STATS_SIZE_WIDTH, player->st_color, INFINITY);
+  player->score_tag = text_init_number(player_get_score(player), center, STATS_SIZE_HEIGHT, STATS_SIZE_WIDTH, player->st_color, INFINITY);
+  // hidden until the first powerup is eaten
+  player->buff_tag = text_init(NULL, center, BUFF_SIZE_HEIGHT, BUFF_SIZE_WIDTH, player->st_color, 0);
+  text_set_static(player->buff_tag, "");
+  text_remove(player->buff_tag);
 
   return player;
 }
 
-double calc_base_speed(player_t *p)
-{
-  return DEFAULT_BASE_SPEED + SPEED_PU * sqrt(p->pu_base_speed);
-}
-
-double calc_rotate_rate(player_t *p)
-{
-  return DEFAULT_TURN_RATE + ROT_PU * sqrt(p->pu_rotate_rate);
-}
-
-double calc_bullet_speed(player_t *p)
-{
-  return DEFAULT_BULLET_SPEED + BULLET_SPEED_PU * sqrt(p->pu_bullet_speed);
-  ;
-}
-
-double calc_dash_boost(player_t *p)
+/** The stat a powerup boosts, for the number of it a player has eaten */
+double calc_stat(player_t *p, powerup_t pu)
 {
-  return DEFAULT_DASH_BOOST + DASH_PU * sqrt(p->pu_dash_boost);
+  return POWERUPS[pu].base + POWERUPS[pu].boost * sqrt(p->pu_counts[pu]);
 }
 
 void player_turn(player_t *p)
@@ -165,14 +152,14 @@ void player_turn(player_t *p)
   {
     body_t *player_head = player_get_head(p);
     vector_t head_vector = body_get_velocity(player_head);
-    vector_t rotated_vector = vec_rotate(head_vector, calc_rotate_rate(p));
+    vector_t rotated_vector = vec_rotate(head_vector, calc_stat(p, PU_ROTATE_RATE));
     body_set_velocity(player_head, rotated_vector);
   }
   if (p->turn_right)
   {
     body_t *player_head = player_get_head(p);
     vector_t head_vector = body_get_velocity(player_head);
-    vector_t rotated_vector = vec_rotate(head_vector, -calc_rotate_rate(p));
+    vector_t rotated_vector = vec_rotate(head_vector, -calc_stat(p, PU_ROTATE_RATE));
     body_set_velocity(player_head, rotated_vector);
   }
 }
@@ -185,67 +172,33 @@ void player_dash(player_t *p)
   {
     body_t *curr_body = (body_t *)list_get(bodies, i);
     vector_t vector_dir = vec_normalize(body_get_velocity(curr_body));
-    vector_t updated_velocity = vec_multiply(calc_dash_boost(p) * vec_norm(body_get_velocity(player_get_head(p))), vector_dir);
+    vector_t updated_velocity = vec_multiply(calc_stat(p, PU_DASH_BOOST) * vec_norm(body_get_velocity(player_get_head(p))), vector_dir);
     body_add_impulse(curr_body, updated_velocity);
   }
   player_refresh_cd_dash(p);
 }
 
-void player_eat(player_t *p, body_t *food, scene_t *scene)
+void player_eat(player_t *p, body_t *food)
 {
-  list_t *info = (list_t *)body_get_info(food);
-  char *body_type = (char *)list_get(info, 0);
-  if (strcmp(body_type, "food") != 0)
+  if (body_get_category(food) != CATEGORY_FOOD)
   {
     return;
   }
-  char *pu_type = (char *)list_get(info, 1);
-
-  char *effect = malloc(sizeof(char) * INFO_MAX_LENGTH);
-  strcpy(effect, "assets/");
-  strcat(effect, pu_type);
-  strcat(effect, ".wav");
-  sdl_play_sound(-1, effect, 0);
-  free(effect);
+  powerup_t pu_type = body_get_tag(food).subtype;
+  assert(pu_type < PU_COUNT);
+  // powerups_load_sounds() must have run, or this isn't a sound handle
+  assert(POWERUPS[pu_type].sound_id != SIZE_MAX);
+  sdl_play_loaded_sound(-1, POWERUPS[pu_type].sound_id, 0);
 
   player_update_food(p);
 
-  if (strcmp(pu_type, "pu_base_speed") == 0)
-  {
-    char *text = malloc(sizeof(char) * INFO_MAX_LENGTH);
-    strcpy(text, "+MS  \0");
-    vector_t center = body_get_centroid(player_get_head(p));
-    scene_add_text(scene, text_init(text, center, BUFF_SIZE_HEIGHT, BUFF_SIZE_WIDTH, p->st_color, 1));
-    p->pu_base_speed++;
-    player_update_pu(p);
-  }
-  else if (strcmp(pu_type, "pu_bullet_speed") == 0)
-  {
-    char *text = malloc(sizeof(char) * INFO_MAX_LENGTH);
-    strcpy(text, "+BMS \0");
-    vector_t center = body_get_centroid(player_get_head(p));
-    scene_add_text(scene, text_init(text, center, BUFF_SIZE_HEIGHT, BUFF_SIZE_WIDTH, p->st_color, 1));
-    p->pu_bullet_speed++;
-    player_update_pu(p);
-  }
-  else if (strcmp(pu_type, "pu_rotate_rate") == 0)
-  {
-    char *text = malloc(sizeof(char) * INFO_MAX_LENGTH);
-    strcpy(text, "+ROT \0");
-    vector_t center = body_get_centroid(player_get_head(p));
-    scene_add_text(scene, text_init(text, center, BUFF_SIZE_HEIGHT, BUFF_SIZE_WIDTH, p->st_color, 1));
-    p->pu_rotate_rate++;
-    player_update_pu(p);
-  }
-  else if (strcmp(pu_type, "pu_dash_boost") == 0)
-  {
-    char *text = malloc(sizeof(char) * INFO_MAX_LENGTH);
-    strcpy(text, "+DASH\0");
-    vector_t center = body_get_centroid(player_get_head(p));
-    scene_add_text(scene, text_init(text, center, BUFF_SIZE_HEIGHT, BUFF_SIZE_WIDTH, p->st_color, 1));
-    p->pu_dash_boost++;
-    player_update_pu(p);
-  }
+  // the tag shows the powerup's text from the table, without copying it
+  text_set_static(p->buff_tag, POWERUPS[pu_type].text);
+  text_move(p->buff_tag, body_get_centroid(player_get_head(p)));
+  text_set_color(p->buff_tag, p->st_color);
+  text_show(p->buff_tag, BUFF_DURATION);
+  p->pu_counts[pu_type]++;
+  player_update_pu(p);
 }
 
 void player_update_stats(player_t *p)
@@ -254,12 +207,11 @@ void player_update_stats(player_t *p)
   text_move(p->score_tag, vec_add(body_get_centroid(player_get_head(p)), STATS_TAG_OFFSET));
 }
 
-void player_draw_inner_glow(player_t *p)
+void player_draw_inner_glow(player_t *p, snapshot_t *snapshot)
 {
   for (size_t i = 0; i < list_size(p->meta_bodies); i++)
   {
     body_t *curr_body = list_get(p->meta_bodies, i);
-    list_t *inner_glow_circle = make_round_shape(SLUG_GLOW_RESOLUTION, INNER_GLOW_SIZE * SLUG_SEGMENT_SIZE, body_get_centroid(curr_body));
     color_t inner_glow_color = body_get_color(curr_body);
     if (inner_glow_color.r != 1)
     {
@@ -273,51 +225,41 @@ void player_draw_inner_glow(player_t *p)
     {
       inner_glow_color.b = inner_glow_color.b + INNER_GLOW_INTENSITY * (1 - inner_glow_color.b);
     }
-    sdl_draw_polygon(inner_glow_circle, inner_glow_color);
-    list_free(inner_glow_circle);
+    snapshot_add_disc(snapshot, body_get_serial(curr_body), body_get_teleports(curr_body), body_get_centroid(curr_body), INNER_GLOW_SIZE * SLUG_SEGMENT_SIZE, inner_glow_color);
   }
 }
 
-void player_render_cosmetics_below(player_t *p)
+void player_render_cosmetics_above(player_t *p, snapshot_t *snapshot)
 {
-  player_update_stats(p);
+  player_draw_inner_glow(p, snapshot);
 }
 
-void player_render_cosmetics_above(player_t *p)
+/**
+ * Cuts a slug's segments from a chain index to its tail
+ * and removes them from the scene.
+ */
+void player_truncate(player_t *p, size_t length, scene_t *scene)
 {
-  player_draw_inner_glow(p);
+  while (list_size(p->meta_bodies) > length)
+  {
+    body_t *segment = list_remove(p->meta_bodies, list_size(p->meta_bodies) - 1);
+    scene_remove_body_handle(scene, body_get_handle(segment));
+  }
 }
 
 void player_hit(player_t *predator, player_t *prey, body_t *body, scene_t *scene)
 {
   sdl_play_sound(-1, "assets/death_dmg.wav", 0);
-  // get index of the body that was hit in meta_bodies
-  double hit_body_idx = 0;
-  for (size_t i = 0; i < list_size(prey->meta_bodies); i++)
-  {
-    if ((body_t *)list_get(prey->meta_bodies, i) == body)
-    {
-      hit_body_idx = i;
-    }
-  }
+  // the segment's tag knows where it is in meta_bodies
+  size_t hit_body_idx = body_get_tag(body).subtype;
+  assert(list_get(prey->meta_bodies, hit_body_idx) == body);
 
   if (hit_body_idx > CRITICAL_BODIES - 1)
   {
     // if you hit tail
-    // remove tails from scene
+    // remove tails from scene, from the end so nothing is shifted
     sdl_play_sound(-1, "assets/bullet_hit.wav", 0);
-    for (size_t i = hit_body_idx; i < list_size(prey->meta_bodies); i++)
-    {
-      for (size_t j = 0; j < scene_bodies(scene); j++)
-      {
-        if ((body_t *)list_get(prey->meta_bodies, i) == scene_get_body(scene, j))
-        {
-          list_remove(prey->meta_bodies, i);
-          i--;
-          scene_remove_body(scene, j);
-        }
-      }
-    }
+    player_truncate(prey, hit_body_idx, scene);
   }
   else
   {
@@ -355,20 +297,11 @@ vector_t player_tail_pos(player_t *p)
   return body_get_centroid(player_get_tail(p));
 }
 
-void to_string(char *c, size_t s)
-{
-  sprintf(c, "%zu", s);
-}
-
-char *player_get_score(player_t *p)
+size_t player_get_score(player_t *p)
 {
   double score_kills = p->stats_kills * SCORE_KILL;
   double score_food = p->stats_food * SCORE_FOOD;
-
-  size_t score = (size_t)score_kills + score_food;
-  char *score_str = malloc(sizeof(char) * INFO_MAX_LENGTH);
-  to_string(score_str, score);
-  return score_str;
+  return (size_t)(score_kills + score_food);
 }
 
 void player_update_kills(player_t *p)
@@ -384,15 +317,9 @@ void player_update_food(player_t *p)
 body_t *player_add_body(player_t *p)
 {
   vector_t player_tail_pos = body_get_centroid(player_get_tail(p));
-  list_t *new_tail = make_round_shape(SLUG_RESOLUTION, SLUG_SEGMENT_SIZE, player_tail_pos);
-  list_t *info = list_init(2, free);
-  char *body_type = malloc(sizeof(char) * INFO_MAX_LENGTH);
-  strcpy(body_type, "player\0");
-  size_t *player_id = malloc(sizeof(size_t));
-  *player_id = p->player_id;
-  list_add(info, body_type);
-  list_add(info, player_id);
-  body_t *curr_body = body_init_with_info(new_tail, SLUG_MASS, p->st_color, info, NULL);
+  prototype_t *segment = prototype_get_round(SLUG_RESOLUTION, SLUG_SEGMENT_SIZE);
+  body_t *curr_body = body_init_with_prototype(segment, player_tail_pos, SLUG_MASS, p->st_color, NULL, NULL);
+  body_set_tag(curr_body, (body_tag_t){.category = CATEGORY_SEGMENT, .owner = p->player_id, .subtype = list_size(p->meta_bodies)});
   body_set_glow(curr_body, true);
   body_set_glow_radius(curr_body, SLUG_SEGMENT_SIZE);
   list_add(p->meta_bodies, curr_body);
@@ -402,8 +329,11 @@ body_t *player_add_body(player_t *p)
 void player_free(void *p)
 {
   player_t *p_casted = (player_t *)p;
-  free(p_casted->ph_applied_force_magnitude);
-  free(p_casted->meta_bodies);
+  // the segments and bullets themselves belong to the scene they were added
+  // to, and the force magnitude to the applied force created with it
+  list_free(p_casted->meta_bodies);
+  list_free(p_casted->bullets);
+  free(p_casted->bullet_ages);
   free(p_casted);
 }
 
@@ -418,8 +348,8 @@ bool player_moves_on_key(player_t *p, char key)
 // ticks a player every couple seconds
 void player_tick_periodic(player_t *p)
 {
-  char *updated_score = player_get_score(p);
-  text_edit(p->score_tag, updated_score);
+  // only the digits that changed are rewritten, and nothing is allocated
+  text_set_number(p->score_tag, player_get_score(p));
 }
 
 void player_tick(player_t *p, double dt)
@@ -445,6 +375,20 @@ void player_tick(player_t *p, double dt)
     p->cd_shoot = 0;
   if (p->cd_collide_player < 0)
     p->cd_collide_player = 0;
+
+  // bullets that miss everything are parked after a while
+  for (size_t i = 0; i < list_size(p->bullets); i++)
+  {
+    body_t *bullet = list_get(p->bullets, i);
+    if (body_in_categories(bullet, CATEGORY_BULLET))
+    {
+      p->bullet_ages[i] += dt;
+      if (p->bullet_ages[i] > BULLET_LIFETIME)
+      {
+        player_park_bullet(bullet);
+      }
+    }
+  }
 }
 
 void player_respawn(player_t *p, scene_t *scene)
@@ -455,36 +399,20 @@ void player_respawn(player_t *p, scene_t *scene)
   p->cd_dash = 0;
   p->cd_collide_player = CD_COLLISION_INITIAL;
 
-  p->pu_base_speed = 0;
-  p->pu_rotate_rate = 0;
-  p->pu_bullet_speed = 0;
-  p->pu_dash_boost = 0;
+  for (size_t i = 0; i < PU_COUNT; i++)
+  {
+    p->pu_counts[i] = 0;
+  }
 
+  // lay the surviving segments out in a line behind the head, so the joints
+  // between them don't have to drag them together from across the map
+  vector_t spawn_point = (vector_t){rand_range(SPAWNBOX_MIN.x, SPAWNBOX_MAX.x), rand_range(SPAWNBOX_MIN.y, SPAWNBOX_MAX.y)};
+  vector_t trail_dir = vec_negate(vec_normalize(body_get_velocity(player_get_head(p))));
+  player_truncate(p, CRITICAL_BODIES, scene);
   for (size_t i = 0; i < list_size(p->meta_bodies); i++)
   {
-    if (i <= CRITICAL_BODIES - 1)
-    {
-      for (size_t j = 0; j < scene_bodies(scene); j++)
-      {
-        if ((body_t *)list_get(p->meta_bodies, i) == scene_get_body(scene, j))
-        {
-          vector_t spawn_point = (vector_t){rand_range(SPAWNBOX_MIN.x, SPAWNBOX_MAX.x), rand_range(SPAWNBOX_MIN.y, SPAWNBOX_MAX.y)};
-          body_set_centroid(scene_get_body(scene, j), spawn_point);
-        }
-      }
-    }
-    else
-    {
-      for (size_t j = 0; j < scene_bodies(scene); j++)
-      {
-        if ((body_t *)list_get(p->meta_bodies, i) == scene_get_body(scene, j))
-        {
-          list_remove(p->meta_bodies, i);
-          i--;
-          scene_remove_body(scene, j);
-        }
-      }
-    }
+    vector_t segment_point = vec_add(spawn_point, vec_multiply(i * SLUG_SEGMENT_SIZE, trail_dir));
+    body_set_centroid(list_get(p->meta_bodies, i), segment_point);
   }
   p->dying = false;
 }
@@ -519,7 +447,7 @@ void player_tick_death(player_t *p, scene_t *scene)
 
 void player_update_pu(player_t *p)
 {
-  player_set_velocity(p, calc_base_speed(p));
+  player_set_velocity(p, calc_stat(p, PU_BASE_SPEED));
 }
 
 void player_refresh_cd_collide_player(player_t *p)
@@ -554,17 +482,24 @@ body_t *player_shoot(player_t *p)
   body_t *head = player_get_head(p);
   vector_t bullet_direction = vec_normalize(body_get_velocity(head));
   vector_t bullet_spawn_position = vec_add(body_get_centroid(head), vec_multiply(BULLET_SPAWN_DISTANCE, bullet_direction));
-  vector_t bullet_velocity = vec_multiply(calc_bullet_speed(p), bullet_direction);
-  list_t *new_bullet = make_round_shape(BULLET_RESOLUTION, BULLET_SIZE, bullet_spawn_position);
-  char *body_type = malloc(sizeof(char) * INFO_MAX_LENGTH);
-  body_type = "bullet";
-  size_t *id = malloc(sizeof(size_t));
-  *id = p->player_id;
-  list_t *info = list_init(2, free);
-  list_add(info, body_type);
-  list_add(info, id);
-  body_t *bullet = body_init_with_info(new_bullet, BULLET_MASS, p->st_color, info, NULL);
+  vector_t bullet_velocity = vec_multiply(calc_stat(p, PU_BULLET_SPEED), bullet_direction);
+  body_t *bullet = list_get(p->bullets, p->next_bullet);
+  p->bullet_ages[p->next_bullet] = 0;
+  p->next_bullet = (p->next_bullet + 1) % list_size(p->bullets);
+  // moving the bullet wakes it and restarts its sweep
+  body_set_centroid(bullet, bullet_spawn_position);
   body_set_velocity(bullet, bullet_velocity);
+  body_set_color(bullet, p->st_color);
+  body_set_tag(bullet, (body_tag_t){.category = CATEGORY_BULLET, .owner = p->player_id});
   player_refresh_cd_bullet(p);
   return bullet;
+}
+
+void player_park_bullet(body_t *bullet)
+{
+  body_tag_t tag = body_get_tag(bullet);
+  tag.category = 0;
+  body_set_tag(bullet, tag);
+  body_set_centroid(bullet, BULLET_PARKING_POSITION);
+  body_sleep(bullet);
 }
\ No newline at end of file
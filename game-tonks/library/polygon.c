@@ -39,6 +39,22 @@ vector_t polygon_centroid(list_t *polygon) {
   return newVec;
 }
 
+double polygon_moment_of_inertia(list_t *polygon, double mass) {
+  vector_t centroid = polygon_centroid(polygon);
+  double numerator = 0.0;
+  double denominator = 0.0;
+  for (size_t i = 0; i < list_size(polygon); i++) {
+    vector_t v1 = vec_subtract(*((vector_t *)list_get(polygon, i)), centroid);
+    vector_t v2 = vec_subtract(
+        *((vector_t *)list_get(polygon, (i + 1) % list_size(polygon))),
+        centroid);
+    double cross = vec_cross(v1, v2);
+    numerator += cross * (vec_dot(v1, v1) + vec_dot(v1, v2) + vec_dot(v2, v2));
+    denominator += cross;
+  }
+  return mass * numerator / (6.0 * denominator);
+}
+
 void polygon_translate(list_t *polygon, vector_t translation) {
   for (size_t i = 0; i < list_size(polygon); i++) {
     vector_t *v = list_get(polygon, i);
@@ -0,0 +1,117 @@
+#include "prototype.h"
+
+#include "list.h"
+#include "polygon.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct prototype {
+  size_t resolution;
+  double radius;
+  list_t *points;    // relative to the centroid
+  size_t *triangles; // a fan around the first vertex
+  size_t triangle_count;
+  double unit_inertia; // moment of inertia of the shape with a mass of 1
+} prototype_t;
+
+/**
+ * The prototypes built so far.
+ * Initially NULL.
+ */
+list_t *prototypes = NULL;
+
+void prototype_free(void *prototype) {
+  prototype_t *casted = prototype;
+  list_free(casted->points);
+  free(casted->triangles);
+  free(casted);
+}
+
+prototype_t *prototype_get_round(size_t resolution, double radius) {
+  assert(resolution >= 3);
+  assert(radius > 0);
+  if (prototypes == NULL) {
+    prototypes = list_init(1, prototype_free);
+  }
+  for (size_t i = 0; i < list_size(prototypes); i++) {
+    prototype_t *prototype = list_get(prototypes, i);
+    if (prototype->resolution == resolution && prototype->radius == radius) {
+      return prototype;
+    }
+  }
+
+  prototype_t *prototype = malloc(sizeof(*prototype));
+  assert(prototype != NULL);
+  prototype->resolution = resolution;
+  prototype->radius = radius;
+  prototype->points = list_init(resolution, free);
+  double increment_angle = 2 * M_PI / resolution;
+  for (size_t i = 0; i < resolution; i++) {
+    vector_t *point = malloc(sizeof(*point));
+    assert(point != NULL);
+    point->x = cos(i * increment_angle) * radius;
+    point->y = sin(i * increment_angle) * radius;
+    list_add(prototype->points, point);
+  }
+
+  // a regular polygon is convex, so a fan covers it
+  prototype->triangle_count = resolution - 2;
+  prototype->triangles =
+      malloc(sizeof(*prototype->triangles) * 3 * prototype->triangle_count);
+  assert(prototype->triangles != NULL);
+  for (size_t i = 0; i < prototype->triangle_count; i++) {
+    prototype->triangles[3 * i] = 0;
+    prototype->triangles[3 * i + 1] = i + 1;
+    prototype->triangles[3 * i + 2] = i + 2;
+  }
+
+  prototype->unit_inertia = polygon_moment_of_inertia(prototype->points, 1);
+  list_add(prototypes, prototype);
+  return prototype;
+}
+
+list_t *prototype_get_points(prototype_t *prototype) {
+  return prototype->points;
+}
+
+double prototype_get_radius(prototype_t *prototype) {
+  return prototype->radius;
+}
+
+const size_t *prototype_get_triangles(prototype_t *prototype) {
+  return prototype->triangles;
+}
+
+size_t prototype_get_triangle_count(prototype_t *prototype) {
+  return prototype->triangle_count;
+}
+
+double prototype_get_inertia(prototype_t *prototype, double mass) {
+  return prototype->unit_inertia * mass;
+}
+
+list_t *prototype_place(prototype_t *prototype, vector_t centroid,
+                        double angle) {
+  size_t n = list_size(prototype->points);
+  list_t *shape = list_init(n, free);
+  double cos_angle = cos(angle);
+  double sin_angle = sin(angle);
+  for (size_t i = 0; i < n; i++) {
+    vector_t *point = list_get(prototype->points, i);
+    vector_t *placed = malloc(sizeof(*placed));
+    assert(placed != NULL);
+    placed->x = centroid.x + cos_angle * point->x - sin_angle * point->y;
+    placed->y = centroid.y + sin_angle * point->x + cos_angle * point->y;
+    list_add(shape, placed);
+  }
+  return shape;
+}
+
+void prototype_free_all(void) {
+  if (prototypes != NULL) {
+    list_free(prototypes);
+    prototypes = NULL;
+  }
+}
@@ -0,0 +1,328 @@
+#include "raster.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the largest block of data a stored (uncompressed) deflate block can hold
+const size_t DEFLATE_STORED_BLOCK = 65535;
+const uint8_t PNG_SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+typedef struct raster {
+  size_t width;
+  size_t height;
+  uint8_t *pixels;
+} raster_t;
+
+typedef struct raster_image {
+  size_t width;
+  size_t height;
+  uint8_t *pixels; // 4 * width bytes per row
+} raster_image_t;
+
+raster_t *raster_init(size_t width, size_t height) {
+  raster_t *raster = malloc(sizeof(raster_t));
+  assert(raster != NULL);
+  raster->width = width;
+  raster->height = height;
+  raster->pixels = calloc(4 * width * height, 1);
+  assert(raster->pixels != NULL);
+  return raster;
+}
+
+void raster_free(raster_t *raster) {
+  free(raster->pixels);
+  free(raster);
+}
+
+size_t raster_get_width(raster_t *raster) { return raster->width; }
+
+size_t raster_get_height(raster_t *raster) { return raster->height; }
+
+uint8_t *raster_get_pixels(raster_t *raster) { return raster->pixels; }
+
+void raster_clear(raster_t *raster, uint8_t r, uint8_t g, uint8_t b) {
+  size_t n = raster->width * raster->height;
+  for (size_t i = 0; i < n; i++) {
+    uint8_t *pixel = &raster->pixels[4 * i];
+    pixel[0] = r;
+    pixel[1] = g;
+    pixel[2] = b;
+    pixel[3] = 255;
+  }
+}
+
+raster_image_t *raster_image_init(size_t width, size_t height,
+                                  const uint8_t *pixels, size_t pitch) {
+  raster_image_t *image = malloc(sizeof(raster_image_t));
+  assert(image != NULL);
+  image->width = width;
+  image->height = height;
+  image->pixels = malloc(4 * width * height);
+  assert(image->pixels != NULL);
+  for (size_t y = 0; y < height; y++) {
+    memcpy(&image->pixels[4 * width * y], &pixels[pitch * y], 4 * width);
+  }
+  return image;
+}
+
+void raster_image_free(raster_image_t *image) {
+  free(image->pixels);
+  free(image);
+}
+
+/**
+ * Twice the signed area of the triangle a, b, p: positive if p is
+ * on the same side of the edge from a to b as the inside of a triangle
+ * that was given positive area.
+ */
+double edge_function(const raster_vertex_t *a, const raster_vertex_t *b,
+                     double px, double py) {
+  return (b->x - a->x) * (py - a->y) - (b->y - a->y) * (px - a->x);
+}
+
+/**
+ * Whether pixels centered exactly on the edge from a to b belong to
+ * the triangle: only top and left edges own them, so a pixel on the edge
+ * shared by two triangles is drawn once.
+ */
+bool is_top_left(const raster_vertex_t *a, const raster_vertex_t *b) {
+  double dy = b->y - a->y;
+  return dy < 0 || (dy == 0 && b->x - a->x > 0);
+}
+
+/** Blends a color (with 8-bit channels) onto a pixel of the framebuffer */
+void blend_pixel(uint8_t *pixel, double r, double g, double b, double a,
+                 raster_blend_t blend) {
+  double alpha = a / 255;
+  switch (blend) {
+  case RASTER_BLEND_NONE:
+    pixel[0] = r;
+    pixel[1] = g;
+    pixel[2] = b;
+    pixel[3] = a;
+    break;
+  case RASTER_BLEND_ALPHA:
+    pixel[0] = r * alpha + pixel[0] * (1 - alpha);
+    pixel[1] = g * alpha + pixel[1] * (1 - alpha);
+    pixel[2] = b * alpha + pixel[2] * (1 - alpha);
+    pixel[3] = a + pixel[3] * (1 - alpha);
+    break;
+  case RASTER_BLEND_ADD:
+    pixel[0] = fmin(r * alpha + pixel[0], 255);
+    pixel[1] = fmin(g * alpha + pixel[1], 255);
+    pixel[2] = fmin(b * alpha + pixel[2], 255);
+    break;
+  }
+}
+
+/** Rasterizes one triangle (see raster_draw_triangles()) */
+void raster_triangle(raster_t *raster, const raster_vertex_t *a,
+                     const raster_vertex_t *b, const raster_vertex_t *c,
+                     raster_image_t *image, raster_blend_t blend) {
+  double area = edge_function(a, b, c->x, c->y);
+  if (area == 0) {
+    return;
+  }
+  if (area < 0) {
+    const raster_vertex_t *swap = b;
+    b = c;
+    c = swap;
+    area = -area;
+  }
+
+  // the pixels whose centers may be inside the triangle
+  double min_x = fmin(fmin(a->x, b->x), c->x);
+  double max_x = fmax(fmax(a->x, b->x), c->x);
+  double min_y = fmin(fmin(a->y, b->y), c->y);
+  double max_y = fmax(fmax(a->y, b->y), c->y);
+  long x0 = fmax(ceil(min_x - 0.5), 0);
+  long x1 = fmin(floor(max_x - 0.5), (double)raster->width - 1);
+  long y0 = fmax(ceil(min_y - 0.5), 0);
+  long y1 = fmin(floor(max_y - 0.5), (double)raster->height - 1);
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  bool owns_bc = is_top_left(b, c);
+  bool owns_ca = is_top_left(c, a);
+  bool owns_ab = is_top_left(a, b);
+  // most triangles are a single color, so skip interpolating colors for them
+  bool flat = image == NULL && a->r == b->r && a->r == c->r &&
+              a->g == b->g && a->g == c->g && a->b == b->b && a->b == c->b &&
+              a->a == b->a && a->a == c->a;
+  // the edge functions change by a constant from one pixel to the next
+  double step_a = c->y - b->y, step_b = a->y - c->y, step_c = b->y - a->y;
+  double inverse_area = 1 / area;
+  for (long y = y0; y <= y1; y++) {
+    double py = y + 0.5;
+    uint8_t *row = &raster->pixels[4 * raster->width * y];
+    double row_a = edge_function(b, c, x0 + 0.5, py);
+    double row_b = edge_function(c, a, x0 + 0.5, py);
+    double row_c = edge_function(a, b, x0 + 0.5, py);
+    for (long x = x0; x <= x1; x++) {
+      double wa = row_a - step_a * (x - x0);
+      double wb = row_b - step_b * (x - x0);
+      double wc = row_c - step_c * (x - x0);
+      if (wa < 0 || wb < 0 || wc < 0 || (wa == 0 && !owns_bc) ||
+          (wb == 0 && !owns_ca) || (wc == 0 && !owns_ab)) {
+        continue;
+      }
+      if (flat) {
+        blend_pixel(&row[4 * x], a->r, a->g, a->b, a->a, blend);
+        continue;
+      }
+
+      wa *= inverse_area;
+      wb *= inverse_area;
+      wc *= inverse_area;
+      double r = wa * a->r + wb * b->r + wc * c->r;
+      double g = wa * a->g + wb * b->g + wc * c->g;
+      double bl = wa * a->b + wb * b->b + wc * c->b;
+      double al = wa * a->a + wb * b->a + wc * c->a;
+      if (image != NULL) {
+        double u = wa * a->u + wb * b->u + wc * c->u;
+        double v = wa * a->v + wb * b->v + wc * c->v;
+        // the nearest texel, clamped to the edge of the image
+        long tx = fmax(u * image->width, 0);
+        long ty = fmax(v * image->height, 0);
+        tx = tx < (long)image->width ? tx : (long)image->width - 1;
+        ty = ty < (long)image->height ? ty : (long)image->height - 1;
+        uint8_t *texel = &image->pixels[4 * (image->width * ty + tx)];
+        r = r * texel[0] / 255;
+        g = g * texel[1] / 255;
+        bl = bl * texel[2] / 255;
+        al = al * texel[3] / 255;
+      }
+      blend_pixel(&row[4 * x], r, g, bl, al, blend);
+    }
+  }
+}
+
+void raster_draw_triangles(raster_t *raster, const raster_vertex_t *vertices,
+                           const int *indices, size_t index_count,
+                           raster_image_t *image, raster_blend_t blend) {
+  assert(index_count % 3 == 0);
+  for (size_t i = 0; i < index_count; i += 3) {
+    raster_triangle(raster, &vertices[indices[i]], &vertices[indices[i + 1]],
+                    &vertices[indices[i + 2]], image, blend);
+  }
+}
+
+bool raster_write_ppm(const char *path, const uint8_t *pixels, size_t width,
+                      size_t height, size_t pitch) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "P6\n%zu %zu\n255\n", width, height);
+  uint8_t *row = malloc(3 * width);
+  assert(row != NULL);
+  for (size_t y = 0; y < height; y++) {
+    const uint8_t *source = &pixels[pitch * y];
+    for (size_t x = 0; x < width; x++) {
+      memcpy(&row[3 * x], &source[4 * x], 3);
+    }
+    fwrite(row, 1, 3 * width, file);
+  }
+  free(row);
+  return fclose(file) == 0;
+}
+
+/** Continues a CRC-32 (as used by PNG and zlib) over some bytes */
+uint32_t crc32_update(uint32_t crc, const uint8_t *bytes, size_t size) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= bytes[i];
+    for (size_t bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xedb88320u & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+/** Stores a 32-bit number most significant byte first */
+void put_big_endian(uint8_t *bytes, uint32_t value) {
+  bytes[0] = value >> 24;
+  bytes[1] = value >> 16;
+  bytes[2] = value >> 8;
+  bytes[3] = value;
+}
+
+/** Writes a PNG chunk: its length, type, data and CRC */
+void write_png_chunk(FILE *file, const char type[4], const uint8_t *data,
+                     size_t size) {
+  uint8_t header[8];
+  put_big_endian(header, size);
+  memcpy(&header[4], type, 4);
+  uint32_t crc = crc32_update(0, &header[4], 4);
+  crc = crc32_update(crc, data, size);
+  uint8_t footer[4];
+  put_big_endian(footer, crc);
+  fwrite(header, 1, sizeof(header), file);
+  fwrite(data, 1, size, file);
+  fwrite(footer, 1, sizeof(footer), file);
+}
+
+bool raster_write_png(const char *path, const uint8_t *pixels, size_t width,
+                      size_t height, size_t pitch) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  fwrite(PNG_SIGNATURE, 1, sizeof(PNG_SIGNATURE), file);
+
+  uint8_t header[13];
+  put_big_endian(header, width);
+  put_big_endian(&header[4], height);
+  header[8] = 8;  // bits per channel
+  header[9] = 6;  // RGBA
+  header[10] = 0; // deflate
+  header[11] = 0; // adaptive filtering
+  header[12] = 0; // not interlaced
+  write_png_chunk(file, "IHDR", header, sizeof(header));
+
+  // each row starts with its filter type, 0 for none
+  size_t raw_size = (4 * width + 1) * height;
+  uint8_t *raw = malloc(raw_size);
+  assert(raw != NULL);
+  for (size_t y = 0; y < height; y++) {
+    uint8_t *row = &raw[(4 * width + 1) * y];
+    row[0] = 0;
+    memcpy(&row[1], &pixels[pitch * y], 4 * width);
+  }
+
+  // a zlib stream of stored deflate blocks, followed by its Adler-32
+  size_t blocks = raw_size / DEFLATE_STORED_BLOCK + 1;
+  size_t data_size = 2 + 5 * blocks + raw_size + 4;
+  uint8_t *data = malloc(data_size);
+  assert(data != NULL);
+  uint8_t *out = data;
+  *out++ = 0x78;
+  *out++ = 0x01;
+  for (size_t start = 0; start == 0 || start < raw_size;
+       start += DEFLATE_STORED_BLOCK) {
+    size_t length = fmin(raw_size - start, DEFLATE_STORED_BLOCK);
+    *out++ = start + length == raw_size;
+    *out++ = length;
+    *out++ = length >> 8;
+    *out++ = ~length;
+    *out++ = ~length >> 8;
+    memcpy(out, &raw[start], length);
+    out += length;
+  }
+  uint32_t sum1 = 1, sum2 = 0;
+  for (size_t i = 0; i < raw_size; i++) {
+    sum1 = (sum1 + raw[i]) % 65521;
+    sum2 = (sum2 + sum1) % 65521;
+  }
+  put_big_endian(out, (sum2 << 16) | sum1);
+  out += 4;
+  write_png_chunk(file, "IDAT", data, out - data);
+  write_png_chunk(file, "IEND", NULL, 0);
+  free(raw);
+  free(data);
+  return fclose(file) == 0;
+}
@@ -1,39 +1,160 @@
 #include "scene.h"
 #include "aux.h"
 #include "body.h"
+#include "collision_package.h"
+#include "constraint.h"
+#include "contact.h"
 #include "force_wrapper.h"
 #include "sdl_wrapper.h"
 #include "state.h"
+#include <assert.h>
+#include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 const size_t DEFAULT_NUM_BODIES = 50;
 const size_t DEFAULT_NUM_TEXTS = 10;
 const size_t DEFAULT_NUM_FORCES = 20;
+const size_t DEFAULT_NUM_CONTACTS = 20;
+const size_t DEFAULT_SOLVER_ITERATIONS = 8;
+const size_t DEFAULT_NUM_CONSTRAINTS = 20;
+const size_t DEFAULT_CONSTRAINT_ITERATIONS = 4;
+const size_t DEFAULT_NUM_CATEGORY_COLLISIONS = 4;
+const size_t DEFAULT_NUM_ATTACHMENTS = 4;
+// marks the end of the list of free body slots
+const size_t NO_FREE_SLOT = SIZE_MAX;
+// ticks an island must spend at rest before it is put to sleep
+const size_t SLEEP_TICKS = 30;
+
+/**
+ * An entry of a scene's collision dispatch table,
+ * see scene_add_category_collision().
+ */
+typedef struct category_collision {
+  uint32_t categories1;
+  uint32_t categories2;
+  collision_handler_t handler;
+  void *aux;
+  free_func_t freer;
+} category_collision_t;
+
+/**
+ * A body in the broadphase: its bounding box grown to cover its sweep,
+ * its category, and the categories it has dispatch table entries with.
+ */
+typedef struct collision_proxy {
+  body_t *body;
+  bounds_t bounds;
+  uint32_t category;
+  uint32_t partners;
+} collision_proxy_t;
+
+typedef enum {
+  ATTACHED_FORCE,
+  ATTACHED_CONTACT,
+  ATTACHED_CONSTRAINT
+} attachment_kind_t;
+
+/** A force, contact or constraint acting on a body, see scene_attach() */
+typedef struct attachment {
+  attachment_kind_t kind;
+  void *item;
+} attachment_t;
+
+/**
+ * A slot of a scene's handle table. Free slots are chained into a list
+ * through next_free, so adding a body reuses one in constant time.
+ * Each slot also lists what acts on its body, so removing the body
+ * doesn't have to search the scene's forces, contacts and constraints.
+ */
+typedef struct body_slot {
+  body_t *body; // NULL if the slot is free
+  uint32_t generation;
+  size_t next_free;
+  // in no particular order; kept when the slot is freed, for reuse
+  attachment_t *attachments;
+  size_t attachment_count;
+  size_t attachment_capacity;
+} body_slot_t;
 
 typedef struct scene {
   list_t *bodies;
   list_t *texts;
   list_t *forces;
+  list_t *contacts;
+  size_t solver_iterations;
+  list_t *constraints;
+  size_t constraint_iterations;
+  bool sleeping;
+  size_t awake_bodies;
+  size_t asleep_bodies;
+  // the islands' union-find forest, kept between ticks to avoid reallocating
+  size_t *island_parents;
+  bool *island_still;
+  size_t island_capacity;
   double time_s;
   bool dev_mode;
+  list_t *category_collisions;
+  collision_proxy_t *proxies;
+  size_t proxy_capacity;
+  body_slot_t *slots;
+  size_t slot_count;
+  size_t slot_capacity;
+  size_t free_slot;
 } scene_t;
 
+void category_collision_free(void *entry) {
+  category_collision_t *collision = entry;
+  if (collision->freer != NULL) {
+    collision->freer(collision->aux);
+  }
+  free(collision);
+}
+
 scene_t *scene_init(void) {
   scene_t *s = malloc(sizeof(scene_t));
   s->bodies = list_init(DEFAULT_NUM_BODIES, body_free);
   s->texts = list_init(DEFAULT_NUM_TEXTS, text_free);
   s->forces = list_init(DEFAULT_NUM_FORCES, force_free);
+  s->contacts = list_init(DEFAULT_NUM_CONTACTS, contact_free);
+  s->solver_iterations = DEFAULT_SOLVER_ITERATIONS;
+  s->constraints = list_init(DEFAULT_NUM_CONSTRAINTS, constraint_free);
+  s->constraint_iterations = DEFAULT_CONSTRAINT_ITERATIONS;
+  s->sleeping = true;
+  s->awake_bodies = 0;
+  s->asleep_bodies = 0;
+  s->island_parents = NULL;
+  s->island_still = NULL;
+  s->island_capacity = 0;
   s->time_s = 0;
   s->dev_mode = false;
+  s->category_collisions =
+      list_init(DEFAULT_NUM_CATEGORY_COLLISIONS, category_collision_free);
+  s->proxies = NULL;
+  s->proxy_capacity = 0;
+  s->slots = NULL;
+  s->slot_count = 0;
+  s->slot_capacity = 0;
+  s->free_slot = NO_FREE_SLOT;
   return s;
 }
 
 void scene_free(scene_t *scene) {
   list_free(scene->bodies);
   list_free(scene->forces);
+  list_free(scene->contacts);
+  list_free(scene->constraints);
   list_free(scene->texts);
+  list_free(scene->category_collisions);
+  for (size_t i = 0; i < scene->slot_count; i++) {
+    free(scene->slots[i].attachments);
+  }
+  free(scene->proxies);
+  free(scene->island_parents);
+  free(scene->island_still);
+  free(scene->slots);
   free(scene);
 }
 
@@ -50,9 +171,96 @@ body_t *scene_get_body(scene_t *scene, size_t index) {
 }
 
 void scene_add_body(scene_t *scene, body_t *body) {
+  size_t index = scene->free_slot;
+  if (index != NO_FREE_SLOT) {
+    scene->free_slot = scene->slots[index].next_free;
+  } else {
+    if (scene->slot_count == scene->slot_capacity) {
+      scene->slot_capacity =
+          scene->slot_capacity == 0 ? DEFAULT_NUM_BODIES
+                                    : 2 * scene->slot_capacity;
+      scene->slots = realloc(scene->slots,
+                             sizeof(body_slot_t) * scene->slot_capacity);
+      assert(scene->slots != NULL);
+    }
+    index = scene->slot_count++;
+    scene->slots[index] = (body_slot_t){.generation = 1};
+  }
+  assert(index <= UINT32_MAX);
+  scene->slots[index].body = body;
+  body_set_handle(body, (body_handle_t){.index = index,
+                                        .generation =
+                                            scene->slots[index].generation});
   list_add(scene->bodies, body);
 }
 
+/**
+ * Frees a removed body's slot, so its handle goes stale,
+ * and adds the slot to the free list.
+ */
+void scene_release_slot(scene_t *scene, body_t *body) {
+  body_handle_t handle = body_get_handle(body);
+  body_slot_t *slot = &scene->slots[handle.index];
+  assert(slot->body == body);
+  slot->body = NULL;
+  // skip generation 0 on wrap around, since zeroed handles are never valid
+  slot->generation = slot->generation == UINT32_MAX ? 1 : slot->generation + 1;
+  slot->next_free = scene->free_slot;
+  scene->free_slot = handle.index;
+}
+
+body_t *scene_get_body_handle(scene_t *scene, body_handle_t handle) {
+  if (handle.index >= scene->slot_count ||
+      scene->slots[handle.index].generation != handle.generation) {
+    return NULL;
+  }
+  return scene->slots[handle.index].body;
+}
+
+/**
+ * Records that a force, contact or constraint acts on a body,
+ * which must already be in the scene.
+ */
+void scene_attach(scene_t *scene, body_t *body, attachment_kind_t kind,
+                  void *item) {
+  body_handle_t handle = body_get_handle(body);
+  assert(scene_get_body_handle(scene, handle) == body);
+  body_slot_t *slot = &scene->slots[handle.index];
+  if (slot->attachment_count == slot->attachment_capacity) {
+    slot->attachment_capacity = slot->attachment_capacity == 0
+                                    ? DEFAULT_NUM_ATTACHMENTS
+                                    : 2 * slot->attachment_capacity;
+    slot->attachments =
+        realloc(slot->attachments,
+                sizeof(attachment_t) * slot->attachment_capacity);
+    assert(slot->attachments != NULL);
+  }
+  slot->attachments[slot->attachment_count++] =
+      (attachment_t){.kind = kind, .item = item};
+}
+
+/** Forgets every record of an item acting on a body */
+void scene_detach(scene_t *scene, body_t *body, void *item) {
+  body_slot_t *slot = &scene->slots[body_get_handle(body).index];
+  size_t i = 0;
+  while (i < slot->attachment_count) {
+    if (slot->attachments[i].item == item) {
+      slot->attachments[i] = slot->attachments[--slot->attachment_count];
+    } else {
+      i++;
+    }
+  }
+}
+
+bool scene_remove_body_handle(scene_t *scene, body_handle_t handle) {
+  body_t *body = scene_get_body_handle(scene, handle);
+  if (body == NULL) {
+    return false;
+  }
+  body_remove(body);
+  return true;
+}
+
 void scene_add_text(scene_t *scene, text_t *text) {
   list_add(scene->texts, text);
 }
@@ -78,25 +286,436 @@ void scene_add_bodies_force_creator(scene_t *scene, force_creator_t forcer,
                                     free_func_t freer) {
   force_wrapper_t *force = force_init_with_bodies(forcer, aux, freer, bodies);
   list_add(scene->forces, force);
+  for (size_t i = 0; i < list_size(bodies); i++) {
+    scene_attach(scene, list_get(bodies, i), ATTACHED_FORCE, force);
+  }
 }
 
-void scene_remove_forces_from_body(scene_t *scene, body_t *body) {
+void scene_add_bodies_collision_creator(scene_t *scene, force_creator_t forcer,
+                                        void *aux, list_t *bodies,
+                                        free_func_t freer) {
+  force_wrapper_t *force = force_init_with_bodies(forcer, aux, freer, bodies);
+  force_set_collision(force, true);
+  list_add(scene->forces, force);
+  for (size_t i = 0; i < list_size(bodies); i++) {
+    scene_attach(scene, list_get(bodies, i), ATTACHED_FORCE, force);
+  }
+}
+
+/** Whether every body in a force's list is asleep */
+bool force_bodies_asleep(force_wrapper_t *force) {
+  list_t *bodies = force_get_bodies(force);
+  if (bodies == NULL) {
+    // we don't know which bodies the force acts on
+    return false;
+  }
+  for (size_t i = 0; i < list_size(bodies); i++) {
+    if (!body_is_asleep(list_get(bodies, i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void scene_create_forces(scene_t *scene) {
+  for (size_t j = 0; j < list_size(scene->forces); j++) {
+    force_wrapper_t *force = list_get(scene->forces, j);
+    if (!force_bodies_asleep(force)) {
+      force_create(force);
+    }
+  }
+}
+
+void scene_add_category_collision(scene_t *scene, uint32_t categories1,
+                                  uint32_t categories2,
+                                  collision_handler_t handler, void *aux,
+                                  free_func_t freer) {
+  category_collision_t *collision = malloc(sizeof(category_collision_t));
+  assert(collision != NULL);
+  collision->categories1 = categories1;
+  collision->categories2 = categories2;
+  collision->handler = handler;
+  collision->aux = aux;
+  collision->freer = freer;
+  list_add(scene->category_collisions, collision);
+}
+
+/** The categories that a body of the given category can collide with */
+uint32_t scene_collision_partners(scene_t *scene, uint32_t category) {
+  uint32_t partners = 0;
+  for (size_t i = 0; i < list_size(scene->category_collisions); i++) {
+    category_collision_t *collision =
+        list_get(scene->category_collisions, i);
+    if (category & collision->categories1) {
+      partners |= collision->categories2;
+    }
+    if (category & collision->categories2) {
+      partners |= collision->categories1;
+    }
+  }
+  return partners;
+}
+
+/** Orders proxies by the left edge of their bounds */
+int proxy_compare(const void *a, const void *b) {
+  double min1 = ((const collision_proxy_t *)a)->bounds.min.x;
+  double min2 = ((const collision_proxy_t *)b)->bounds.min.x;
+  return (min1 > min2) - (min1 < min2);
+}
+
+/**
+ * Calls the handlers of every dispatch table entry matching a pair of
+ * bodies, in either order, until one of them removes a body.
+ * The categories are read again before each entry, since a handler
+ * may retag a body, e.g. to take it out of play.
+ */
+void scene_dispatch_pair(scene_t *scene, body_t *body1, body_t *body2) {
+  for (size_t i = 0; i < list_size(scene->category_collisions); i++) {
+    if (body_is_removed(body1) || body_is_removed(body2)) {
+      return;
+    }
+    uint32_t category1 = body_get_category(body1);
+    uint32_t category2 = body_get_category(body2);
+    category_collision_t *collision =
+        list_get(scene->category_collisions, i);
+    if ((category1 & collision->categories1) &&
+        (category2 & collision->categories2)) {
+      collision_handle_bodies(body1, body2, collision->handler,
+                              collision->aux);
+    } else if ((category2 & collision->categories1) &&
+               (category1 & collision->categories2)) {
+      collision_handle_bodies(body2, body1, collision->handler,
+                              collision->aux);
+    }
+  }
+}
+
+/**
+ * Finds the pairs of bodies whose categories have a dispatch table entry
+ * and whose bounds overlap with sweep and prune: the bounds are sorted by
+ * their left edge, so each body only needs to be compared with the bodies
+ * after it that start before it ends.
+ */
+void scene_dispatch_collisions(scene_t *scene) {
+  if (list_size(scene->category_collisions) == 0) {
+    return;
+  }
+  size_t num_bodies = scene_bodies(scene);
+  if (scene->proxy_capacity < num_bodies) {
+    scene->proxy_capacity = 2 * num_bodies;
+    scene->proxies = realloc(scene->proxies, sizeof(collision_proxy_t) *
+                                                 scene->proxy_capacity);
+    assert(scene->proxies != NULL);
+  }
+
+  size_t num_proxies = 0;
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    uint32_t category = body_get_category(body);
+    uint32_t partners = scene_collision_partners(scene, category);
+    if (partners == 0 || body_is_removed(body)) {
+      continue;
+    }
+    // cover where the body was at the start of the tick too,
+    // so swept collisions with bullets aren't pruned
+    bounds_t bounds = body_get_bounds(body);
+    vector_t sweep = body_get_sweep(body);
+    bounds.min = (vector_t){fmin(bounds.min.x, bounds.min.x - sweep.x),
+                            fmin(bounds.min.y, bounds.min.y - sweep.y)};
+    bounds.max = (vector_t){fmax(bounds.max.x, bounds.max.x - sweep.x),
+                            fmax(bounds.max.y, bounds.max.y - sweep.y)};
+    scene->proxies[num_proxies++] = (collision_proxy_t){
+        .body = body, .bounds = bounds, .category = category,
+        .partners = partners};
+  }
+  qsort(scene->proxies, num_proxies, sizeof(collision_proxy_t), proxy_compare);
+
+  for (size_t i = 0; i < num_proxies; i++) {
+    collision_proxy_t *proxy1 = &scene->proxies[i];
+    for (size_t j = i + 1; j < num_proxies; j++) {
+      collision_proxy_t *proxy2 = &scene->proxies[j];
+      if (proxy2->bounds.min.x > proxy1->bounds.max.x) {
+        break;
+      }
+      if (!(proxy1->partners & proxy2->category) ||
+          proxy2->bounds.min.y > proxy1->bounds.max.y ||
+          proxy1->bounds.min.y > proxy2->bounds.max.y ||
+          (body_is_asleep(proxy1->body) && body_is_asleep(proxy2->body))) {
+        continue;
+      }
+      scene_dispatch_pair(scene, proxy1->body, proxy2->body);
+    }
+  }
+}
+
+void scene_add_contact(scene_t *scene, contact_t *contact) {
+  list_add(scene->contacts, contact);
+  scene_attach(scene, contact_get_body1(contact), ATTACHED_CONTACT, contact);
+  scene_attach(scene, contact_get_body2(contact), ATTACHED_CONTACT, contact);
+}
+
+size_t scene_get_solver_iterations(scene_t *scene) {
+  return scene->solver_iterations;
+}
+
+void scene_set_solver_iterations(scene_t *scene, size_t iterations) {
+  scene->solver_iterations = iterations;
+}
+
+void scene_solve_contacts(scene_t *scene, double dt) {
+  size_t num_contacts = list_size(scene->contacts);
+  if (num_contacts == 0) {
+    return;
+  }
+  for (size_t i = 0; i < num_contacts; i++) {
+    contact_t *contact = list_get(scene->contacts, i);
+    body_t *body1 = contact_get_body1(contact);
+    body_t *body2 = contact_get_body2(contact);
+    if (body_is_asleep(body1) && body_is_asleep(body2)) {
+      continue;
+    }
+    contact_prepare(contact, dt);
+    if (contact_is_touching(contact)) {
+      body_wake_pair(body1, body2);
+    }
+  }
+  for (size_t iter = 0; iter < scene->solver_iterations; iter++) {
+    for (size_t i = 0; i < num_contacts; i++) {
+      contact_t *contact = list_get(scene->contacts, i);
+      if (!body_is_asleep(contact_get_body1(contact)) ||
+          !body_is_asleep(contact_get_body2(contact))) {
+        contact_solve(contact);
+      }
+    }
+  }
+}
+
+void scene_add_constraint(scene_t *scene, constraint_t *constraint) {
+  list_add(scene->constraints, constraint);
+  scene_attach(scene, constraint_get_body1(constraint), ATTACHED_CONSTRAINT,
+               constraint);
+  scene_attach(scene, constraint_get_body2(constraint), ATTACHED_CONSTRAINT,
+               constraint);
+}
+
+size_t scene_get_constraint_iterations(scene_t *scene) {
+  return scene->constraint_iterations;
+}
+
+void scene_set_constraint_iterations(scene_t *scene, size_t iterations) {
+  scene->constraint_iterations = iterations;
+}
+
+void scene_solve_constraints(scene_t *scene, double dt) {
+  size_t num_constraints = list_size(scene->constraints);
+  for (size_t i = 0; i < num_constraints; i++) {
+    constraint_reset(list_get(scene->constraints, i));
+  }
+  for (size_t iter = 0; iter < scene->constraint_iterations; iter++) {
+    for (size_t i = 0; i < num_constraints; i++) {
+      constraint_t *constraint = list_get(scene->constraints, i);
+      if (!body_is_asleep(constraint_get_body1(constraint)) ||
+          !body_is_asleep(constraint_get_body2(constraint))) {
+        constraint_solve(constraint, dt);
+      }
+    }
+  }
+}
+
+bool scene_get_sleeping(scene_t *scene) { return scene->sleeping; }
+
+void scene_set_sleeping(scene_t *scene, bool sleeping) {
+  scene->sleeping = sleeping;
+  if (!sleeping) {
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+      body_wake(scene_get_body(scene, i));
+    }
+  }
+}
+
+size_t scene_get_awake_bodies(scene_t *scene) { return scene->awake_bodies; }
+
+size_t scene_get_asleep_bodies(scene_t *scene) {
+  return scene->asleep_bodies;
+}
+
+/** Finds the root of an island, compressing the path to it */
+size_t island_find(size_t *parent, size_t i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+/** Merges the islands of two bodies, unless either has infinite mass */
+void island_union(size_t *parent, body_t *body1, body_t *body2) {
+  if (body_get_mass(body1) == INFINITY || body_get_mass(body2) == INFINITY) {
+    return;
+  }
+  size_t root1 = island_find(parent, body_get_island(body1));
+  size_t root2 = island_find(parent, body_get_island(body2));
+  parent[root1] = root2;
+}
+
+/**
+ * Groups the bodies into islands and puts each island to sleep once all of
+ * its bodies have been at rest for SLEEP_TICKS ticks, or wakes it up if any
+ * of them is moving. Bodies with infinite mass sleep on their own.
+ */
+void scene_update_sleep(scene_t *scene) {
+  size_t num_bodies = scene_bodies(scene);
+  if (!scene->sleeping) {
+    scene->awake_bodies = num_bodies;
+    scene->asleep_bodies = 0;
+    return;
+  }
+
+  if (scene->island_capacity < num_bodies) {
+    scene->island_capacity = 2 * num_bodies;
+    scene->island_parents = realloc(scene->island_parents,
+                                    sizeof(size_t) * scene->island_capacity);
+    scene->island_still =
+        realloc(scene->island_still, sizeof(bool) * scene->island_capacity);
+    assert(scene->island_parents != NULL && scene->island_still != NULL);
+  }
+  size_t *parent = scene->island_parents;
+  bool *island_still = scene->island_still;
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    body_set_island(body, i);
+    parent[i] = i;
+    island_still[i] = true;
+    if (!body_is_asleep(body)) {
+      body_update_still_ticks(body);
+    }
+  }
+
+  for (size_t i = 0; i < list_size(scene->constraints); i++) {
+    constraint_t *constraint = list_get(scene->constraints, i);
+    island_union(parent, constraint_get_body1(constraint),
+                 constraint_get_body2(constraint));
+  }
+  for (size_t i = 0; i < list_size(scene->contacts); i++) {
+    contact_t *contact = list_get(scene->contacts, i);
+    if (contact_is_touching(contact)) {
+      island_union(parent, contact_get_body1(contact),
+                   contact_get_body2(contact));
+    }
+  }
   for (size_t i = 0; i < list_size(scene->forces); i++) {
     force_wrapper_t *force = list_get(scene->forces, i);
     list_t *bodies = force_get_bodies(force);
-    for (size_t j = 0; j < list_size(bodies); j++) {
-      if (list_get(bodies, j) == body) {
-        force_remove(list_get(scene->forces, i));
-        break;
+    if (bodies == NULL || force_is_collision(force)) {
+      continue;
+    }
+    for (size_t j = 1; j < list_size(bodies); j++) {
+      island_union(parent, list_get(bodies, 0), list_get(bodies, j));
+    }
+  }
+
+  // asleep bodies are still however few ticks they have counted, e.g. ones
+  // put to sleep with body_sleep() rather than by the scene; they stop
+  // counting once asleep, and waking them restarts the count
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    if (!body_is_asleep(body) && body_get_still_ticks(body) < SLEEP_TICKS) {
+      island_still[island_find(parent, i)] = false;
+    }
+  }
+  scene->awake_bodies = 0;
+  scene->asleep_bodies = 0;
+  for (size_t i = 0; i < num_bodies; i++) {
+    body_t *body = scene_get_body(scene, i);
+    bool still = island_still[island_find(parent, i)];
+    if (still && !body_is_asleep(body)) {
+      body_sleep(body);
+    } else if (!still && body_is_asleep(body)) {
+      body_wake(body);
+    }
+    if (body_is_asleep(body)) {
+      scene->asleep_bodies++;
+    } else {
+      scene->awake_bodies++;
+    }
+  }
+}
+
+void scene_remove_forces_from_body(scene_t *scene, body_t *body) {
+  body_slot_t *slot = &scene->slots[body_get_handle(body).index];
+  for (size_t i = 0; i < slot->attachment_count; i++) {
+    attachment_t attachment = slot->attachments[i];
+    // the other bodies it acts on must forget it before it is freed
+    if (attachment.kind == ATTACHED_FORCE) {
+      force_wrapper_t *force = attachment.item;
+      if (force_is_removed(force)) {
+        continue; // the body is in the force's list more than once
+      }
+      force_remove(force);
+      list_t *bodies = force_get_bodies(force);
+      for (size_t j = 0; j < list_size(bodies); j++) {
+        if (list_get(bodies, j) != body) {
+          scene_detach(scene, list_get(bodies, j), force);
+        }
+      }
+    } else if (attachment.kind == ATTACHED_CONTACT) {
+      contact_t *contact = attachment.item;
+      contact_remove(contact);
+      body_t *other = contact_get_body1(contact) == body
+                          ? contact_get_body2(contact)
+                          : contact_get_body1(contact);
+      if (other != body) {
+        scene_detach(scene, other, contact);
+      }
+    } else {
+      constraint_t *constraint = attachment.item;
+      constraint_remove(constraint);
+      body_t *other = constraint_get_body1(constraint) == body
+                          ? constraint_get_body2(constraint)
+                          : constraint_get_body1(constraint);
+      if (other != body) {
+        scene_detach(scene, other, constraint);
       }
     }
   }
+  slot->attachment_count = 0;
+}
+
+bool scene_body_removed(void *body) { return body_is_removed(body); }
+
+bool scene_force_removed(void *force) { return force_is_removed(force); }
+
+bool scene_contact_removed(void *contact) {
+  return contact_is_removed(contact);
+}
+
+bool scene_constraint_removed(void *constraint) {
+  return constraint_is_removed(constraint);
+}
+
+/**
+ * Frees the removed bodies and the forces, contacts and constraints that
+ * were removed along with them, compacting each list in a single pass
+ * that keeps the rest in order (so bodies are still drawn in the order
+ * they were added).
+ */
+void scene_sweep_removed(scene_t *scene) {
+  list_remove_if(scene->bodies, scene_body_removed);
+  list_remove_if(scene->forces, scene_force_removed);
+  list_remove_if(scene->contacts, scene_contact_removed);
+  list_remove_if(scene->constraints, scene_constraint_removed);
 }
 
 void scene_draw(scene_t *scene) {
   for (size_t i = 0; i < scene_bodies(scene); i++) {
     body_t *body = scene_get_body(scene, i);
-    sdl_draw_polygon(body_get_shape(body), body_get_color(body));
+    bounds_t bounds = body_get_bounds(body);
+    if (!sdl_is_visible(bounds.min, bounds.max)) {
+      continue;
+    }
+    list_t *shape = body_get_shape(body);
+    sdl_draw_polygon(shape, body_get_color(body));
+    list_free(shape);
     if (scene->dev_mode) {
       body_draw_acl(body);
     }
@@ -105,57 +724,52 @@ void scene_draw(scene_t *scene) {
 
 void scene_tick(scene_t *scene, double dt) {
   scene->time_s += dt;
-  for (size_t j = 0; j < list_size(scene->forces); j++) {
-    force_create(list_get(scene->forces, j));
-  }
+  scene_create_forces(scene);
+  scene_dispatch_collisions(scene);
+  scene_solve_contacts(scene, dt);
+  bool removed_any = false;
   for (size_t i = 0; i < scene_bodies(scene); i++) {
     body_t *curr_body = scene_get_body(scene, i);
     if (body_is_removed(curr_body)) {
       scene_remove_forces_from_body(scene, curr_body);
-      body_t *removed_body = list_remove(scene->bodies, i);
-      body_free(removed_body);
-      i--;
-    } else {
+      scene_release_slot(scene, curr_body);
+      removed_any = true;
+    } else if (!body_is_asleep(curr_body)) {
       body_tick(curr_body, dt);
     }
   }
-  for (size_t i = 0; i < list_size(scene->forces); i++) {
-    force_wrapper_t *curr_force = list_get(scene->forces, i);
-    if (force_is_removed(curr_force)) {
-      force_wrapper_t *removed_force = list_remove(scene->forces, i);
-      force_free(removed_force);
-      i--;
-    }
+  if (removed_any) {
+    scene_sweep_removed(scene);
   }
+  scene_solve_constraints(scene, dt);
+  scene_update_sleep(scene);
 }
 
 void scene_tick_canon(scene_t *scene, double dt) {
   scene->time_s += dt;
   // forces tick
-  for (size_t j = 0; j < list_size(scene->forces); j++) {
-    force_create(list_get(scene->forces, j));
-  }
+  scene_create_forces(scene);
+  scene_dispatch_collisions(scene);
+  scene_solve_contacts(scene, dt);
   // body tick
+  bool removed_any = false;
   for (size_t i = 0; i < scene_bodies(scene); i++) {
     body_t *curr_body = scene_get_body(scene, i);
     if (body_is_removed(curr_body)) {
       scene_remove_forces_from_body(scene, curr_body);
-      body_t *removed_body = list_remove(scene->bodies, i);
-      body_free(removed_body);
-      i--;
+      scene_release_slot(scene, curr_body);
+      removed_any = true;
     } else {
-      body_tick_canon(curr_body, dt);
-      if (body_get_glow(curr_body)) body_draw_glow(curr_body, body_get_glow_radius(curr_body));
+      if (!body_is_asleep(curr_body)) {
+        body_tick_canon(curr_body, dt);
+      }
     }
   }
-  for (size_t i = 0; i < list_size(scene->forces); i++) {
-    force_wrapper_t *curr_force = list_get(scene->forces, i);
-    if (force_is_removed(curr_force)) {
-      force_wrapper_t *removed_force = list_remove(scene->forces, i);
-      force_free(removed_force);
-      i--;
-    }
+  if (removed_any) {
+    scene_sweep_removed(scene);
   }
+  scene_solve_constraints(scene, dt);
+  scene_update_sleep(scene);
 
   // texts tick
   for (size_t i = 0; i < list_size(scene->texts); i++) {
@@ -168,27 +782,23 @@ void scene_tick_canon(scene_t *scene, double dt) {
 
 void scene_tick_canon_no_reset(scene_t *scene, double dt) {
   scene->time_s += dt;
-  for (size_t j = 0; j < list_size(scene->forces); j++) {
-    force_create(list_get(scene->forces, j));
-  }
+  scene_create_forces(scene);
+  scene_dispatch_collisions(scene);
+  scene_solve_contacts(scene, dt);
+  bool removed_any = false;
   for (size_t i = 0; i < scene_bodies(scene); i++) {
     body_t *curr_body = scene_get_body(scene, i);
     if (body_is_removed(curr_body)) {
       scene_remove_forces_from_body(scene, curr_body);
-      body_t *removed_body = list_remove(scene->bodies, i);
-      body_free(removed_body);
-      i--;
-      body_tick_canon_no_reset(curr_body, dt);
+      scene_release_slot(scene, curr_body);
+      removed_any = true;
     }
   }
-    for (size_t i = 0; i < list_size(scene->forces); i++) {
-    force_wrapper_t *curr_force = list_get(scene->forces, i);
-    if (force_is_removed(curr_force)) {
-      force_wrapper_t *removed_force = list_remove(scene->forces, i);
-      force_free(removed_force);
-      i--;
-    }
+  if (removed_any) {
+    scene_sweep_removed(scene);
   }
+  scene_solve_constraints(scene, dt);
+  scene_update_sleep(scene);
 }
 
 void scene_accel_reset(scene_t *scene) {
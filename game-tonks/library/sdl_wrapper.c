@@ -1,6 +1,7 @@
 #include "sdl_wrapper.h"
 #include "list.h"
 #include "body.h"
+#include "raster.h"
 #include "scene.h"
 #include "state.h"
 #include <SDL2/SDL.h>
@@ -8,6 +9,7 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_ttf.h>
@@ -19,10 +21,94 @@ const int WINDOW_WIDTH = 1600;
 const int WINDOW_HEIGHT = 900;
 const double MS_PER_S = 1e3;
 
-const TTF_Font *font;
+TTF_Font *font;
 const double frequency = 44100;
 const int channels = 2;
 const int chunk_size = 2048;
+// the printable ASCII characters, which are rasterized into the glyph atlas
+const char FIRST_GLYPH = ' ';
+const char LAST_GLYPH = '~';
+// a body's glow is GLOW_FACTOR rings, each GLOW_INCREASE wider than the last
+// and GLOW_REDUCTION times as opaque, starting at GLOW_SCALE times the
+// opacity of the body
+const double GLOW_SCALE = 0.1;
+const size_t GLOW_FACTOR = 8;
+const double GLOW_REDUCTION = 0.8;
+const double GLOW_INCREASE = 3;
+// resolution of the cached glow and disc sprites
+const double SPRITE_TEXELS_PER_UNIT = 4;
+
+/**
+ * A run of consecutive triangles that share a texture and blend mode,
+ * drawn with a single SDL_RenderGeometry() call.
+ * A run with a texture only holds quads, four vertices and six indices each.
+ */
+typedef struct draw_run {
+  void *texture; // created by the backend, or NULL
+  SDL_BlendMode blend_mode;
+  size_t first_index;
+  size_t index_count;
+} draw_run_t;
+
+/**
+ * One thing drawn during a frame (a polygon, a sprite, a line of text...).
+ */
+typedef struct draw_item {
+  uint32_t hash;   // of the item's vertices, texture and blend mode
+  SDL_Rect bounds; // the pixels the item covers
+} draw_item_t;
+
+/**
+ * A white sprite with a radial alpha profile, tinted when it is drawn.
+ */
+typedef struct sprite {
+  double radius;
+  bool glow;
+  double size; // the width and height of the sprite, in scene units
+  void *texture;
+} sprite_t;
+
+/**
+ * An image loaded from disk, along with the path it was loaded from.
+ */
+typedef struct texture {
+  char *path;
+  void *texture; // NULL if the image couldn't be loaded
+} texture_t;
+
+/**
+ * A sound effect loaded from disk, along with the path it was loaded from.
+ */
+typedef struct sound {
+  char *path;
+  Mix_Chunk *chunk;
+} sound_t;
+
+/**
+ * What frames are drawn with: SDL's renderer, or the software rasterizer
+ * in raster.c. The drawing functions only queue triangles (see begin_item())
+ * and never talk to the backend, which creates the textures they draw with
+ * and draws each frame's runs once the frame ends. Textures are opaque
+ * pointers to everything but the backend that created them.
+ */
+typedef struct backend {
+  void *(*create_texture)(SDL_Surface *surface);
+  void (*free_texture)(void *texture);
+  // draws the queued frame and displays it
+  void (*draw_frame)(int width, int height);
+  // the last frame's RGBA pixels and bytes per row, or NULL if unavailable
+  const uint8_t *(*get_pixels)(size_t *pitch);
+} backend_t;
+
+typedef struct context {
+    SDL_Rect dest;
+    SDL_Texture *ashug_tex;
+
+    TTF_Font *font;
+    SDL_Texture *text_tex;
+
+    vector_t ashug_vec;
+} context_t;
 
 /**
  * The coordinate at the center of the screen.
@@ -33,13 +119,43 @@ vector_t center;
  */
 vector_t max_diff;
 /**
- * The SDL window where the scene is rendered.
+ * The transform from scene coordinates to window pixels: the window's center
+ * in pixels and the number of pixels per scene unit.
+ * Computed once per frame by update_view() instead of for every vertex.
+ */
+vector_t view_window_center;
+double view_scale;
+/**
+ * The corners of the part of the scene the window shows.
+ */
+vector_t view_min;
+vector_t view_max;
+/**
+ * The SDL window where the scene is rendered, or NULL when drawing offscreen.
+ */
+SDL_Window *window = NULL;
+/**
+ * The renderer used to draw the scene, or NULL with the software backend.
+ */
+SDL_Renderer *renderer = NULL;
+/**
+ * What frames are drawn with, set by sdl_init() or sdl_init_offscreen().
  */
-SDL_Window *window;
+const backend_t *backend = NULL;
 /**
- * The renderer used to draw the scene.
+ * When drawing without a window, the size of the frames, and what they are
+ * drawn onto: a surface for SDL's renderer, or the software framebuffer.
  */
-SDL_Renderer *renderer;
+int offscreen_width;
+int offscreen_height;
+SDL_Surface *offscreen_surface = NULL;
+raster_t *raster = NULL;
+/**
+ * The frame's vertices converted for the software rasterizer.
+ * Kept between frames and only grows.
+ */
+raster_vertex_t *raster_vertices = NULL;
+size_t raster_vertex_capacity = 0;
 /**
  * The keypress handler, or NULL if none has been configured.
  */
@@ -54,16 +170,81 @@ uint32_t key_start_timestamp;
  * Initially 0.
  */
 clock_t last_clock = 0;
-
-typedef struct context {
-    SDL_Rect dest;
-    SDL_Texture *ashug_tex;
-
-    TTF_Font *font;
-    SDL_Texture *text_tex;
-
-    vector_t ashug_vec;
-} context_t;
+/**
+ * A texture with every printable character of the font side by side,
+ * rasterized once in white so text can be drawn in any color.
+ * NULL if the font couldn't be loaded.
+ */
+void *glyph_atlas = NULL;
+/**
+ * The size of each character's cell in the glyph atlas, in pixels.
+ */
+int glyph_width;
+int glyph_height;
+/**
+ * Everything drawn since sdl_begin_frame(), in the order it was drawn,
+ * as window-space vertices and the indices of each triangle's corners.
+ * Nothing reaches the renderer until sdl_end_frame().
+ * The buffers are kept between frames and only grow.
+ */
+SDL_Vertex *frame_vertices = NULL;
+int *frame_indices = NULL;
+size_t frame_vertex_count = 0;
+size_t frame_index_count = 0;
+size_t frame_vertex_capacity = 0;
+size_t frame_index_capacity = 0;
+/**
+ * The frame's triangles, split into runs that share a texture and blend mode.
+ */
+draw_run_t *frame_runs = NULL;
+size_t frame_run_count = 0;
+size_t frame_run_capacity = 0;
+/**
+ * The things drawn this frame and last frame, for dirty rendering.
+ * Only recorded while dirty rendering is enabled.
+ */
+draw_item_t *frame_items = NULL;
+size_t frame_item_count = 0;
+size_t frame_item_capacity = 0;
+draw_item_t *last_frame_items = NULL;
+size_t last_frame_item_count = 0;
+size_t last_frame_item_capacity = 0;
+/**
+ * The first vertex of the item being drawn (see begin_item()).
+ */
+size_t item_first_vertex = 0;
+/**
+ * Whether only the parts of the window that changed since the last frame
+ * are redrawn (see sdl_set_dirty_rendering()).
+ */
+bool dirty_rendering = false;
+/**
+ * A copy of the last frame that dirty rendering draws the changes onto,
+ * or NULL if it has to be redrawn from scratch.
+ */
+SDL_Texture *canvas = NULL;
+int canvas_width;
+int canvas_height;
+/**
+ * Whether the renderer supports SDL_RenderGeometry().
+ * Cleared the first time it fails, after which triangles are drawn
+ * one at a time with the gfx primitives and quads are copied one at a time.
+ */
+bool geometry_supported = true;
+/**
+ * The glow and disc sprites rendered so far (see get_sprite()).
+ */
+list_t *sprites = NULL;
+/**
+ * The textures loaded by sdl_load_texture(), indexed by their handles.
+ * Initially NULL.
+ */
+list_t *textures = NULL;
+/**
+ * The sound effects loaded so far, so each file is only read from disk once.
+ * Initially NULL.
+ */
+list_t *sounds = NULL;
 
 
 vector_t get_mouse_pos(void) {
@@ -76,15 +257,21 @@ vector_t get_mouse_pos(void) {
   return dimensions;
 }
 
+/** Gets the size of the window, or of the frames when drawing offscreen */
+void get_window_size(int *width, int *height) {
+  if (window != NULL) {
+    SDL_GetWindowSize(window, width, height);
+  } else {
+    *width = offscreen_width;
+    *height = offscreen_height;
+  }
+}
+
 /** Computes the center of the window in pixel coordinates */
 vector_t get_window_center(void) {
-  int *width = malloc(sizeof(*width)), *height = malloc(sizeof(*height));
-  assert(width != NULL);
-  assert(height != NULL);
-  SDL_GetWindowSize(window, width, height);
-  vector_t dimensions = {.x = *width, .y = *height};
-  free(width);
-  free(height);
+  int width, height;
+  get_window_size(&width, &height);
+  vector_t dimensions = {.x = width, .y = height};
   return vec_multiply(0.5, dimensions);
 }
 
@@ -100,19 +287,41 @@ double get_scene_scale(vector_t window_center) {
   return x_scale < y_scale ? x_scale : y_scale;
 }
 
+/**
+ * Recomputes the transform from scene coordinates to window pixels
+ * and the part of the scene the window shows,
+ * after the window is resized or the camera moves.
+ */
+void update_view(void) {
+  view_window_center = get_window_center();
+  view_scale = get_scene_scale(view_window_center);
+  vector_t half_view = vec_multiply(1 / view_scale, view_window_center);
+  view_min = vec_subtract(center, half_view);
+  view_max = vec_add(center, half_view);
+}
+
 /** Maps a scene coordinate to a window coordinate */
-vector_t get_window_position(vector_t scene_pos, vector_t window_center) {
+vector_t get_window_position(vector_t scene_pos) {
   // Scale scene coordinates by the scaling factor
   // and map the center of the scene to the center of the window
   vector_t scene_center_offset = vec_subtract(scene_pos, center);
-  double scale = get_scene_scale(window_center);
-  vector_t pixel_center_offset = vec_multiply(scale, scene_center_offset);
-  vector_t pixel = {.x = round(window_center.x + pixel_center_offset.x),
+  vector_t pixel_center_offset = vec_multiply(view_scale, scene_center_offset);
+  vector_t pixel = {.x = round(view_window_center.x + pixel_center_offset.x),
                     // Flip y axis since positive y is down on the screen
-                    .y = round(window_center.y - pixel_center_offset.y)};
+                    .y = round(view_window_center.y - pixel_center_offset.y)};
   return pixel;
 }
 
+bool sdl_is_visible(vector_t min, vector_t max) {
+  return min.x <= view_max.x && max.x >= view_min.x && min.y <= view_max.y &&
+         max.y >= view_min.y;
+}
+
+void sdl_set_camera(vector_t camera) {
+  center = camera;
+  update_view();
+}
+
 /**
  * Converts an SDL key code to a char.
  * 7-bit ASCII characters are just returned
@@ -134,28 +343,6 @@ char get_keycode(SDL_Keycode key) {
   }
 }
 
-void sdl_init(vector_t min, vector_t max) {
-  // Check parameters
-  assert(min.x < max.x);
-  assert(min.y < max.y);
-
-  center = vec_multiply(0.5, vec_add(min, max));
-  max_diff = vec_subtract(max, center);
-  SDL_Init(SDL_INIT_EVERYTHING);
-  TTF_Init();
-  font = TTF_OpenFont("assets/joystix.ttf", 100);
-
-  // init mixer
-  if( Mix_OpenAudio( frequency, MIX_DEFAULT_FORMAT, channels, chunk_size ) < 0 ) {
-      printf( "SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError() );
-  }
-
-  window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_CENTERED,
-                            SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT,
-                            SDL_WINDOW_RESIZABLE);
-  renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
-}
-
 bool sdl_is_done(state_t *state) {
   SDL_Event *event = malloc(sizeof(*event));
   assert(event != NULL);
@@ -189,9 +376,370 @@ bool sdl_is_done(state_t *state) {
   return false;
 }
 
-void sdl_clear(void) {
+/**
+ * Grows an array so it can hold at least needed elements,
+ * at least doubling its capacity so appending stays cheap.
+ */
+void *grow_array(void *array, size_t *capacity, size_t needed,
+                 size_t element_size) {
+  if (needed <= *capacity) {
+    return array;
+  }
+  *capacity = fmax(2 * *capacity, needed);
+  array = realloc(array, element_size * *capacity);
+  assert(array != NULL);
+  return array;
+}
+
+/**
+ * Starts drawing an item with a texture (or NULL) and blend mode,
+ * making room for its vertices and indices at the end of the frame.
+ * Must be followed by end_item() once the item's triangles are queued.
+ */
+void begin_item(void *texture, SDL_BlendMode blend_mode,
+                size_t vertices, size_t indices) {
+  frame_vertices = grow_array(frame_vertices, &frame_vertex_capacity,
+                              frame_vertex_count + vertices,
+                              sizeof(*frame_vertices));
+  frame_indices = grow_array(frame_indices, &frame_index_capacity,
+                             frame_index_count + indices,
+                             sizeof(*frame_indices));
+  draw_run_t *last_run =
+      frame_run_count == 0 ? NULL : &frame_runs[frame_run_count - 1];
+  if (last_run == NULL || last_run->texture != texture ||
+      last_run->blend_mode != blend_mode) {
+    frame_runs = grow_array(frame_runs, &frame_run_capacity,
+                            frame_run_count + 1, sizeof(*frame_runs));
+    frame_runs[frame_run_count++] =
+        (draw_run_t){.texture = texture,
+                     .blend_mode = blend_mode,
+                     .first_index = frame_index_count,
+                     .index_count = 0};
+  }
+  item_first_vertex = frame_vertex_count;
+}
+
+/** Queues a vertex of the current item */
+void push_vertex(double x, double y, SDL_Color color, double u, double v) {
+  frame_vertices[frame_vertex_count++] =
+      (SDL_Vertex){.position = {.x = x, .y = y},
+                   .color = color,
+                   .tex_coord = {.x = u, .y = v}};
+}
+
+/** Queues a triangle between three vertices of the frame */
+void push_triangle(size_t a, size_t b, size_t c) {
+  frame_indices[frame_index_count++] = a;
+  frame_indices[frame_index_count++] = b;
+  frame_indices[frame_index_count++] = c;
+}
+
+/**
+ * Queues a textured quad from its top left corner to its bottom right corner,
+ * showing the part of the texture between the texture coordinates u0, v0
+ * and u1, v1.
+ */
+void push_quad(double x0, double y0, double x1, double y1, double u0,
+               double v0, double u1, double v1, SDL_Color color) {
+  size_t first = frame_vertex_count;
+  push_vertex(x0, y0, color, u0, v0);
+  push_vertex(x1, y0, color, u1, v0);
+  push_vertex(x1, y1, color, u1, v1);
+  push_vertex(x0, y1, color, u0, v1);
+  push_triangle(first, first + 1, first + 2);
+  push_triangle(first, first + 2, first + 3);
+}
+
+/** Hashes bytes into a running FNV-1a hash */
+uint32_t hash_bytes(uint32_t hash, const void *bytes, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ ((const uint8_t *)bytes)[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * Finishes the current item: adds its triangles to the current run and,
+ * when dirty rendering, records what it looks like and where it is.
+ */
+void end_item(void) {
+  draw_run_t *run = &frame_runs[frame_run_count - 1];
+  run->index_count = frame_index_count - run->first_index;
+  if (!dirty_rendering || frame_vertex_count == item_first_vertex) {
+    return;
+  }
+
+  SDL_Vertex *vertices = &frame_vertices[item_first_vertex];
+  size_t n = frame_vertex_count - item_first_vertex;
+  uint32_t hash = 2166136261u;
+  hash = hash_bytes(hash, &run->texture, sizeof(run->texture));
+  hash = hash_bytes(hash, &run->blend_mode, sizeof(run->blend_mode));
+  hash = hash_bytes(hash, vertices, sizeof(*vertices) * n);
+  double min_x = INFINITY, min_y = INFINITY;
+  double max_x = -INFINITY, max_y = -INFINITY;
+  for (size_t i = 0; i < n; i++) {
+    min_x = fmin(min_x, vertices[i].position.x);
+    min_y = fmin(min_y, vertices[i].position.y);
+    max_x = fmax(max_x, vertices[i].position.x);
+    max_y = fmax(max_y, vertices[i].position.y);
+  }
+  // a pixel of padding covers edges that are rounded outwards
+  SDL_Rect bounds = {.x = floor(min_x) - 1, .y = floor(min_y) - 1};
+  bounds.w = ceil(max_x) + 1 - bounds.x;
+  bounds.h = ceil(max_y) + 1 - bounds.y;
+  frame_items = grow_array(frame_items, &frame_item_capacity,
+                           frame_item_count + 1, sizeof(*frame_items));
+  frame_items[frame_item_count++] =
+      (draw_item_t){.hash = hash, .bounds = bounds};
+}
+
+/**
+ * Returns twice the signed area of a polygon in the frame's vertex buffer;
+ * its sign tells which way the polygon winds.
+ */
+double polygon_winding(size_t *polygon, size_t n) {
+  double area = 0;
+  for (size_t i = 0; i < n; i++) {
+    SDL_FPoint a = frame_vertices[polygon[i]].position;
+    SDL_FPoint b = frame_vertices[polygon[(i + 1) % n]].position;
+    area += a.x * b.y - b.x * a.y;
+  }
+  return area;
+}
+
+/** The cross product of b - a and c - b, positive for a left turn */
+double turn(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c) {
+  return (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+}
+
+/**
+ * Returns whether a polygon in the frame's vertex buffer is convex,
+ * i.e. whether all its corners turn the same way.
+ */
+bool is_convex(size_t first, size_t n) {
+  int direction = 0;
+  for (size_t i = 0; i < n; i++) {
+    double cross = turn(frame_vertices[first + i].position,
+                        frame_vertices[first + (i + 1) % n].position,
+                        frame_vertices[first + (i + 2) % n].position);
+    int sign = (cross > 0) - (cross < 0);
+    if (sign != 0 && direction != 0 && sign != direction) {
+      return false;
+    }
+    if (sign != 0) {
+      direction = sign;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns whether the corner at b of a polygon winding in the given
+ * direction is an ear: a convex corner whose triangle holds no other vertex.
+ */
+bool is_ear(size_t *polygon, size_t n, size_t corner, double winding) {
+  SDL_FPoint a = frame_vertices[polygon[(corner + n - 1) % n]].position;
+  SDL_FPoint b = frame_vertices[polygon[corner]].position;
+  SDL_FPoint c = frame_vertices[polygon[(corner + 1) % n]].position;
+  if (turn(a, b, c) * winding <= 0) {
+    return false;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (i == corner || i == (corner + 1) % n || i == (corner + n - 1) % n) {
+      continue;
+    }
+    SDL_FPoint p = frame_vertices[polygon[i]].position;
+    if (turn(a, b, p) * winding >= 0 && turn(b, c, p) * winding >= 0 &&
+        turn(c, a, p) * winding >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Queues the triangles of a concave polygon whose n vertices start at first
+ * in the frame's vertex buffer, by clipping its ears one at a time.
+ */
+void push_concave_polygon(size_t first, size_t n) {
+  size_t *polygon = malloc(sizeof(*polygon) * n);
+  assert(polygon != NULL);
+  for (size_t i = 0; i < n; i++) {
+    polygon[i] = first + i;
+  }
+  double winding = polygon_winding(polygon, n);
+  size_t corner = 0;
+  size_t checked = 0;
+  while (n > 3 && checked < n) {
+    if (is_ear(polygon, n, corner, winding)) {
+      push_triangle(polygon[(corner + n - 1) % n], polygon[corner],
+                    polygon[(corner + 1) % n]);
+      memmove(&polygon[corner], &polygon[corner + 1],
+              sizeof(*polygon) * (n - corner - 1));
+      n--;
+      corner %= n;
+      checked = 0;
+    } else {
+      corner = (corner + 1) % n;
+      checked++;
+    }
+  }
+  // whatever is left (a triangle, or a self-intersecting remainder) is fanned
+  for (size_t i = 1; i + 1 < n; i++) {
+    push_triangle(polygon[0], polygon[i], polygon[i + 1]);
+  }
+  free(polygon);
+}
+
+/**
+ * Draws a run of triangles on the current render target.
+ */
+void draw_run(draw_run_t *run) {
+  SDL_SetRenderDrawBlendMode(renderer, run->blend_mode);
+  if (run->texture != NULL) {
+    SDL_SetTextureBlendMode(run->texture, run->blend_mode);
+  }
+  if (geometry_supported &&
+      SDL_RenderGeometry(renderer, run->texture, frame_vertices,
+                         frame_vertex_count, &frame_indices[run->first_index],
+                         run->index_count) < 0) {
+    geometry_supported = false;
+  }
+  if (geometry_supported) {
+    return;
+  }
+
+  int *indices = &frame_indices[run->first_index];
+  if (run->texture != NULL) {
+    // copy each quad's part of the texture, tinted like its vertices
+    int texture_width, texture_height;
+    SDL_QueryTexture(run->texture, NULL, NULL, &texture_width,
+                     &texture_height);
+    for (size_t i = 0; i < run->index_count; i += 6) {
+      SDL_Vertex *top_left = &frame_vertices[indices[i]];
+      SDL_Vertex *bottom_right = &frame_vertices[indices[i + 2]];
+      SDL_Rect source = {
+          .x = top_left->tex_coord.x * texture_width,
+          .y = top_left->tex_coord.y * texture_height,
+          .w = (bottom_right->tex_coord.x - top_left->tex_coord.x) *
+               texture_width,
+          .h = (bottom_right->tex_coord.y - top_left->tex_coord.y) *
+               texture_height};
+      SDL_Rect dest = {.x = top_left->position.x,
+                       .y = top_left->position.y,
+                       .w = bottom_right->position.x - top_left->position.x,
+                       .h = bottom_right->position.y - top_left->position.y};
+      SDL_Color color = top_left->color;
+      SDL_SetTextureColorMod(run->texture, color.r, color.g, color.b);
+      SDL_SetTextureAlphaMod(run->texture, color.a);
+      SDL_RenderCopy(renderer, run->texture, &source, &dest);
+    }
+    SDL_SetTextureColorMod(run->texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(run->texture, 255);
+  } else {
+    for (size_t i = 0; i < run->index_count; i += 3) {
+      SDL_Vertex *a = &frame_vertices[indices[i]];
+      SDL_Vertex *b = &frame_vertices[indices[i + 1]];
+      SDL_Vertex *c = &frame_vertices[indices[i + 2]];
+      filledTrigonRGBA(renderer, a->position.x, a->position.y, b->position.x,
+                       b->position.y, c->position.x, c->position.y,
+                       a->color.r, a->color.g, a->color.b, a->color.a);
+    }
+  }
+}
+
+/** Draws every run of the frame on the current render target */
+void draw_runs(void) {
+  for (size_t i = 0; i < frame_run_count; i++) {
+    draw_run(&frame_runs[i]);
+  }
+}
+
+/** Grows a rectangle so it also covers another one */
+void add_to_rect(SDL_Rect *rect, bool *empty, SDL_Rect other) {
+  if (*empty) {
+    *rect = other;
+    *empty = false;
+    return;
+  }
+  int right = fmax(rect->x + rect->w, other.x + other.w);
+  int bottom = fmax(rect->y + rect->h, other.y + other.h);
+  rect->x = fmin(rect->x, other.x);
+  rect->y = fmin(rect->y, other.y);
+  rect->w = right - rect->x;
+  rect->h = bottom - rect->y;
+}
+
+/**
+ * Updates the canvas with the parts of the frame that changed since
+ * the last frame, by comparing what was drawn in both frames item by item.
+ * Returns false if the renderer can't draw to a texture.
+ */
+bool update_canvas(int width, int height) {
+  bool redraw_all = false;
+  if (canvas == NULL || canvas_width != width || canvas_height != height) {
+    if (canvas != NULL) {
+      SDL_DestroyTexture(canvas);
+    }
+    canvas = SDL_RenderTargetSupported(renderer)
+                 ? SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_TARGET, width, height)
+                 : NULL;
+    if (canvas == NULL) {
+      return false;
+    }
+    canvas_width = width;
+    canvas_height = height;
+    redraw_all = true;
+  }
+
+  SDL_Rect dirty = {.x = 0, .y = 0, .w = width, .h = height};
+  bool empty = !redraw_all;
+  if (!redraw_all && frame_item_count != last_frame_item_count) {
+    // items were added or removed, so they can't be matched up
+    empty = false;
+  } else if (!redraw_all) {
+    for (size_t i = 0; i < frame_item_count; i++) {
+      if (frame_items[i].hash != last_frame_items[i].hash) {
+        add_to_rect(&dirty, &empty, last_frame_items[i].bounds);
+        add_to_rect(&dirty, &empty, frame_items[i].bounds);
+      }
+    }
+  }
+  if (empty) {
+    return true;
+  }
+
+  SDL_SetRenderTarget(renderer, canvas);
+  SDL_RenderSetClipRect(renderer, &dirty);
+  // SDL_RenderClear() ignores the clip rectangle
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-  SDL_RenderClear(renderer);
+  SDL_RenderFillRect(renderer, &dirty);
+  draw_runs();
+  SDL_RenderSetClipRect(renderer, NULL);
+  SDL_SetRenderTarget(renderer, NULL);
+  return true;
+}
+
+void sdl_set_dirty_rendering(bool enabled) {
+  if (enabled != dirty_rendering) {
+    dirty_rendering = enabled;
+    // the canvas doesn't hold the frames drawn in the meantime
+    last_frame_item_count = 0;
+    if (canvas != NULL) {
+      SDL_DestroyTexture(canvas);
+      canvas = NULL;
+    }
+  }
+}
+
+void sdl_begin_frame(void) {
+  update_view();
+  frame_vertex_count = 0;
+  frame_index_count = 0;
+  frame_run_count = 0;
+  frame_item_count = 0;
 }
 
 void sdl_draw_polygon(list_t *points, color_t color) {
@@ -203,55 +751,457 @@ void sdl_draw_polygon(list_t *points, color_t color) {
   assert(0 <= color.b && color.b <= 1);
   assert(0 <= color.a && color.a <= 1);
 
-  vector_t window_center = get_window_center();
+  begin_item(NULL, SDL_BLENDMODE_BLEND, n, 3 * (n - 2));
 
   // Convert each vertex to a point on screen
-  int16_t *x_points = malloc(sizeof(*x_points) * n),
-          *y_points = malloc(sizeof(*y_points) * n);
-  assert(x_points != NULL);
-  assert(y_points != NULL);
+  size_t first = frame_vertex_count;
+  SDL_Color pixel_color = {color.r * 255, color.g * 255, color.b * 255,
+                           color.a * 255};
   for (size_t i = 0; i < n; i++) {
     vector_t *vertex = list_get(points, i);
-    vector_t pixel = get_window_position(*vertex, window_center);
-    x_points[i] = pixel.x;
-    y_points[i] = pixel.y;
+    vector_t pixel = get_window_position(*vertex);
+    push_vertex(pixel.x, pixel.y, pixel_color, 0, 0);
+  }
+
+  if (is_convex(first, n)) {
+    // a fan of triangles around the first vertex
+    for (size_t i = 1; i + 1 < n; i++) {
+      push_triangle(first, first + i, first + i + 1);
+    }
+  } else {
+    push_concave_polygon(first, n);
+  }
+  end_item();
+}
+
+void sdl_draw_prototype(prototype_t *prototype, vector_t centroid,
+                        double angle, color_t color) {
+  double radius = prototype_get_radius(prototype);
+  vector_t extent = {.x = radius, .y = radius};
+  if (!sdl_is_visible(vec_subtract(centroid, extent),
+                      vec_add(centroid, extent))) {
+    return;
+  }
+
+  list_t *points = prototype_get_points(prototype);
+  size_t n = list_size(points);
+  size_t triangle_count = prototype_get_triangle_count(prototype);
+  const size_t *triangles = prototype_get_triangles(prototype);
+  vector_t pixel = get_window_position(centroid);
+  // the scene's y axis points up and the window's points down
+  double cos_angle = cos(angle) * view_scale;
+  double sin_angle = sin(angle) * view_scale;
+  SDL_Color pixel_color = {color.r * 255, color.g * 255, color.b * 255,
+                           color.a * 255};
+
+  begin_item(NULL, SDL_BLENDMODE_BLEND, n, 3 * triangle_count);
+  size_t first = frame_vertex_count;
+  for (size_t i = 0; i < n; i++) {
+    vector_t *point = list_get(points, i);
+    push_vertex(pixel.x + cos_angle * point->x - sin_angle * point->y,
+                pixel.y - sin_angle * point->x - cos_angle * point->y,
+                pixel_color, 0, 0);
+  }
+  for (size_t i = 0; i < triangle_count; i++) {
+    push_triangle(first + triangles[3 * i], first + triangles[3 * i + 1],
+                  first + triangles[3 * i + 2]);
+  }
+  end_item();
+}
+
+/**
+ * The opacity of a white glow around a body of opacity 1
+ * at a distance from its center: the opacity of all the glow rings
+ * that reach that far, drawn on top of each other.
+ */
+double glow_alpha(double radius, double distance) {
+  double ring_alpha = GLOW_SCALE;
+  double transparency = 1;
+  for (size_t j = 0; j < GLOW_FACTOR; j++) {
+    ring_alpha *= GLOW_REDUCTION;
+    if (distance <= radius + GLOW_INCREASE * j) {
+      transparency *= 1 - ring_alpha;
+    }
+  }
+  return 1 - transparency;
+}
+
+void sprite_free(void *sprite) {
+  backend->free_texture(((sprite_t *)sprite)->texture);
+  free(sprite);
+}
+
+/**
+ * Returns the cached sprite of a glow (see glow_alpha()) or of a disc
+ * with a given radius, rendering it the first time it is needed.
+ */
+sprite_t *get_sprite(double radius, bool glow) {
+  if (sprites == NULL) {
+    sprites = list_init(1, sprite_free);
+  }
+  for (size_t i = 0; i < list_size(sprites); i++) {
+    sprite_t *sprite = list_get(sprites, i);
+    if (sprite->radius == radius && sprite->glow == glow) {
+      return sprite;
+    }
+  }
+
+  double outer_radius =
+      glow ? radius + GLOW_INCREASE * (GLOW_FACTOR - 1) : radius;
+  // one texel of padding on each side keeps the edge from being cut off
+  int texels = ceil(2 * outer_radius * SPRITE_TEXELS_PER_UNIT) + 2;
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+      0, texels, texels, 32, SDL_PIXELFORMAT_RGBA32);
+  assert(surface != NULL);
+  for (int y = 0; y < texels; y++) {
+    uint8_t *row = (uint8_t *)surface->pixels + y * surface->pitch;
+    for (int x = 0; x < texels; x++) {
+      double dx = (x + 0.5 - texels / 2.0) / SPRITE_TEXELS_PER_UNIT;
+      double dy = (y + 0.5 - texels / 2.0) / SPRITE_TEXELS_PER_UNIT;
+      double distance = sqrt(dx * dx + dy * dy);
+      double alpha;
+      if (glow) {
+        alpha = glow_alpha(radius, distance);
+      } else {
+        // fade out over the last texel for a smooth edge
+        alpha = fmin(fmax((radius - distance) * SPRITE_TEXELS_PER_UNIT, 0), 1);
+      }
+      // RGBA32 is laid out as r, g, b, a bytes
+      row[4 * x] = 255;
+      row[4 * x + 1] = 255;
+      row[4 * x + 2] = 255;
+      row[4 * x + 3] = round(255 * alpha);
+    }
+  }
+
+  sprite_t *sprite = malloc(sizeof(sprite_t));
+  assert(sprite != NULL);
+  sprite->radius = radius;
+  sprite->glow = glow;
+  sprite->size = texels / SPRITE_TEXELS_PER_UNIT;
+  sprite->texture = backend->create_texture(surface);
+  SDL_FreeSurface(surface);
+  list_add(sprites, sprite);
+  return sprite;
+}
+
+/** Queues a sprite centered on a point, tinted with a color */
+void draw_sprite(sprite_t *sprite, vector_t center, color_t color,
+                 SDL_BlendMode blend_mode) {
+  vector_t extent = {.x = sprite->size / 2, .y = sprite->size / 2};
+  if (!sdl_is_visible(vec_subtract(center, extent), vec_add(center, extent))) {
+    return;
   }
+  vector_t pixel = get_window_position(center);
+  double half_size = sprite->size * view_scale / 2;
+  SDL_Color tint = {color.r * 255, color.g * 255, color.b * 255,
+                    color.a * 255};
+  begin_item(sprite->texture, blend_mode, 4, 6);
+  push_quad(pixel.x - half_size, pixel.y - half_size, pixel.x + half_size,
+            pixel.y + half_size, 0, 0, 1, 1, tint);
+  end_item();
+}
+
+void sdl_draw_glow(vector_t center, double radius, color_t color) {
+  draw_sprite(get_sprite(radius, true), center, color, SDL_BLENDMODE_ADD);
+}
 
-  // Draw polygon with the given color
-  filledPolygonRGBA(renderer, x_points, y_points, n, color.r * 255,
-                    color.g * 255, color.b * 255, color.a * 255); 
-  free(x_points);
-  free(y_points);
+void sdl_draw_disc(vector_t center, double radius, color_t color) {
+  draw_sprite(get_sprite(radius, false), center, color, SDL_BLENDMODE_BLEND);
 }
 
-void sdl_show(void) {
+void *renderer_create_texture(SDL_Surface *surface) {
+  return SDL_CreateTextureFromSurface(renderer, surface);
+}
+
+void renderer_free_texture(void *texture) { SDL_DestroyTexture(texture); }
+
+/**
+ * Draws the frame with SDL's renderer, redrawing only what changed
+ * if dirty rendering is enabled, and presents it.
+ */
+void renderer_draw_frame(int width, int height) {
+  if (dirty_rendering && update_canvas(width, height)) {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_RenderCopy(renderer, canvas, NULL, NULL);
+  } else {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    draw_runs();
+  }
+
   // Draw boundary lines
-  vector_t window_center = get_window_center();
   vector_t max = vec_add(center, max_diff),
            min = vec_subtract(center, max_diff);
-  vector_t max_pixel = get_window_position(max, window_center),
-           min_pixel = get_window_position(min, window_center);
-  SDL_Rect *boundary = malloc(sizeof(*boundary));
-  boundary->x = min_pixel.x;
-  boundary->y = max_pixel.y;
-  boundary->w = max_pixel.x - min_pixel.x;
-  boundary->h = min_pixel.y - max_pixel.y;
+  vector_t max_pixel = get_window_position(max),
+           min_pixel = get_window_position(min);
+  SDL_Rect boundary = {.x = min_pixel.x,
+                       .y = max_pixel.y,
+                       .w = max_pixel.x - min_pixel.x,
+                       .h = min_pixel.y - max_pixel.y};
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-  SDL_RenderDrawRect(renderer, boundary);
-  free(boundary);
+  SDL_RenderDrawRect(renderer, &boundary);
 
   SDL_RenderPresent(renderer);
 }
 
+const uint8_t *renderer_get_pixels(size_t *pitch) {
+  if (offscreen_surface == NULL) {
+    return NULL;
+  }
+  *pitch = offscreen_surface->pitch;
+  return offscreen_surface->pixels;
+}
+
+void *software_create_texture(SDL_Surface *surface) {
+  SDL_Surface *rgba =
+      SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+  assert(rgba != NULL);
+  raster_image_t *image =
+      raster_image_init(rgba->w, rgba->h, rgba->pixels, rgba->pitch);
+  SDL_FreeSurface(rgba);
+  return image;
+}
+
+void software_free_texture(void *texture) { raster_image_free(texture); }
+
+/** Converts an SDL blend mode to the rasterizer's */
+raster_blend_t get_raster_blend(SDL_BlendMode blend_mode) {
+  switch (blend_mode) {
+  case SDL_BLENDMODE_NONE:
+    return RASTER_BLEND_NONE;
+  case SDL_BLENDMODE_ADD:
+    return RASTER_BLEND_ADD;
+  default:
+    return RASTER_BLEND_ALPHA;
+  }
+}
+
+/**
+ * Rasterizes the whole frame onto the software framebuffer.
+ * Dirty rendering is ignored: the framebuffer is cleared every frame.
+ */
+void software_draw_frame(int width, int height) {
+  raster_vertices = grow_array(raster_vertices, &raster_vertex_capacity,
+                               frame_vertex_count, sizeof(*raster_vertices));
+  for (size_t i = 0; i < frame_vertex_count; i++) {
+    SDL_Vertex *vertex = &frame_vertices[i];
+    raster_vertices[i] = (raster_vertex_t){.x = vertex->position.x,
+                                           .y = vertex->position.y,
+                                           .r = vertex->color.r,
+                                           .g = vertex->color.g,
+                                           .b = vertex->color.b,
+                                           .a = vertex->color.a,
+                                           .u = vertex->tex_coord.x,
+                                           .v = vertex->tex_coord.y};
+  }
+  raster_clear(raster, 0, 0, 0);
+  for (size_t i = 0; i < frame_run_count; i++) {
+    draw_run_t *run = &frame_runs[i];
+    raster_draw_triangles(raster, raster_vertices,
+                          &frame_indices[run->first_index], run->index_count,
+                          run->texture, get_raster_blend(run->blend_mode));
+  }
+}
+
+const uint8_t *software_get_pixels(size_t *pitch) {
+  *pitch = 4 * raster_get_width(raster);
+  return raster_get_pixels(raster);
+}
+
+const backend_t RENDERER_BACKEND = {.create_texture = renderer_create_texture,
+                                    .free_texture = renderer_free_texture,
+                                    .draw_frame = renderer_draw_frame,
+                                    .get_pixels = renderer_get_pixels};
+const backend_t SOFTWARE_BACKEND = {.create_texture = software_create_texture,
+                                    .free_texture = software_free_texture,
+                                    .draw_frame = software_draw_frame,
+                                    .get_pixels = software_get_pixels};
+
+/**
+ * Rasterizes every printable character of the font into the glyph atlas,
+ * one cell per character. Each cell is as wide as the widest character.
+ */
+void glyph_atlas_init(void) {
+  if (font == NULL) {
+    printf("Could not load font! SDL_ttf Error: %s\n", TTF_GetError());
+    return;
+  }
+  glyph_width = 0;
+  glyph_height = TTF_FontHeight(font);
+  for (char c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+    int advance;
+    TTF_GlyphMetrics(font, c, NULL, NULL, NULL, NULL, &advance);
+    if (advance > glyph_width) {
+      glyph_width = advance;
+    }
+  }
+
+  size_t glyph_count = LAST_GLYPH - FIRST_GLYPH + 1;
+  SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(
+      0, glyph_width * glyph_count, glyph_height, 32, SDL_PIXELFORMAT_RGBA32);
+  assert(atlas != NULL);
+  SDL_Color white = {255, 255, 255, 255};
+  for (char c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+    SDL_Surface *glyph = TTF_RenderGlyph_Blended(font, c, white);
+    if (glyph == NULL) {
+      continue;
+    }
+    // copy the glyph's alpha into the atlas instead of blending it
+    SDL_SetSurfaceBlendMode(glyph, SDL_BLENDMODE_NONE);
+    SDL_Rect cell = {.x = (c - FIRST_GLYPH) * glyph_width + (glyph_width - glyph->w) / 2,
+                     .y = 0,
+                     .w = glyph->w,
+                     .h = glyph->h};
+    SDL_BlitSurface(glyph, NULL, atlas, &cell);
+    SDL_FreeSurface(glyph);
+  }
+  glyph_atlas = backend->create_texture(atlas);
+  SDL_FreeSurface(atlas);
+}
+
+void sdl_init(vector_t min, vector_t max) {
+  // Check parameters
+  assert(min.x < max.x);
+  assert(min.y < max.y);
+
+  center = vec_multiply(0.5, vec_add(min, max));
+  max_diff = vec_subtract(max, center);
+  SDL_Init(SDL_INIT_EVERYTHING);
+  TTF_Init();
+  font = TTF_OpenFont("assets/joystix.ttf", 100);
+
+  // init mixer
+  if( Mix_OpenAudio( frequency, MIX_DEFAULT_FORMAT, channels, chunk_size ) < 0 ) {
+      printf( "SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError() );
+  }
+
+  window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_CENTERED,
+                            SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT,
+                            SDL_WINDOW_RESIZABLE);
+  renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
+  backend = &RENDERER_BACKEND;
+  glyph_atlas_init();
+  update_view();
+}
+
+void sdl_init_offscreen(vector_t min, vector_t max, int width, int height,
+                        renderer_type_t type) {
+  // Check parameters
+  assert(min.x < max.x);
+  assert(min.y < max.y);
+  assert(width > 0 && height > 0);
+
+  center = vec_multiply(0.5, vec_add(min, max));
+  max_diff = vec_subtract(max, center);
+  TTF_Init();
+  font = TTF_OpenFont("assets/joystix.ttf", 100);
+
+  offscreen_width = width;
+  offscreen_height = height;
+  if (type == RENDERER_SOFTWARE) {
+    raster = raster_init(width, height);
+    backend = &SOFTWARE_BACKEND;
+  } else {
+    offscreen_surface = SDL_CreateRGBSurfaceWithFormat(
+        0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    assert(offscreen_surface != NULL);
+    renderer = SDL_CreateSoftwareRenderer(offscreen_surface);
+    assert(renderer != NULL);
+    backend = &RENDERER_BACKEND;
+  }
+  glyph_atlas_init();
+  update_view();
+}
+
+bool sdl_save_frame(const char *path) {
+  size_t pitch;
+  const uint8_t *pixels = backend->get_pixels(&pitch);
+  if (pixels == NULL) {
+    return false;
+  }
+  size_t length = strlen(path);
+  if (length >= 4 && strcmp(&path[length - 4], ".png") == 0) {
+    return raster_write_png(path, pixels, offscreen_width, offscreen_height,
+                            pitch);
+  }
+  return raster_write_ppm(path, pixels, offscreen_width, offscreen_height,
+                          pitch);
+}
+
+void sdl_free(void) {
+  sdl_free_textures();
+  if (sprites != NULL) {
+    list_free(sprites);
+    sprites = NULL;
+  }
+  if (glyph_atlas != NULL) {
+    backend->free_texture(glyph_atlas);
+    glyph_atlas = NULL;
+  }
+  if (canvas != NULL) {
+    SDL_DestroyTexture(canvas);
+    canvas = NULL;
+  }
+  if (renderer != NULL) {
+    SDL_DestroyRenderer(renderer);
+    renderer = NULL;
+  }
+  if (window != NULL) {
+    SDL_DestroyWindow(window);
+    window = NULL;
+  }
+  if (offscreen_surface != NULL) {
+    SDL_FreeSurface(offscreen_surface);
+    offscreen_surface = NULL;
+  }
+  if (raster != NULL) {
+    raster_free(raster);
+    raster = NULL;
+  }
+  if (font != NULL) {
+    TTF_CloseFont(font);
+    font = NULL;
+  }
+  // the next frame can't be compared with one drawn by another backend
+  last_frame_item_count = 0;
+  backend = NULL;
+}
+
+void sdl_end_frame(void) {
+  int width, height;
+  get_window_size(&width, &height);
+  backend->draw_frame(width, height);
+
+  // remember what was drawn, to compare the next frame against
+  draw_item_t *items = last_frame_items;
+  size_t capacity = last_frame_item_capacity;
+  last_frame_items = frame_items;
+  last_frame_item_count = frame_item_count;
+  last_frame_item_capacity = frame_item_capacity;
+  frame_items = items;
+  frame_item_capacity = capacity;
+  frame_item_count = 0;
+}
+
 void sdl_render_scene(scene_t *scene) {
   size_t body_count = scene_bodies(scene);
   for (size_t i = 0; i < body_count; i++) {
     body_t *body = scene_get_body(scene, i);
+    bounds_t bounds = body_get_bounds(body);
+    if (!sdl_is_visible(bounds.min, bounds.max)) {
+      continue;
+    }
+    prototype_t *prototype = body_get_prototype(body);
+    if (prototype != NULL) {
+      sdl_draw_prototype(prototype, body_get_centroid(body),
+                         body_get_rotation(body), body_get_color(body));
+      continue;
+    }
     list_t *shape = body_get_shape(body);
     sdl_draw_polygon(shape, body_get_color(body));
     list_free(shape);
   }
-  sdl_show();
 }
 
 void sdl_on_key(key_handler_t handler) { key_handler = handler; }
@@ -265,68 +1215,179 @@ double time_since_last_tick(void) {
   return difference;
 }
 
-void sdl_move_text(list_t *l, vector_t pos, double height, double width) {
-  SDL_Rect *message_rectangle = (SDL_Rect *) list_get(l, 1);
-  message_rectangle->x = pos.x - width / 2;
-  message_rectangle->y = WINDOW_HEIGHT - pos.y - height / 2;
-  message_rectangle->w = width;
-  message_rectangle->h = height;
+void sdl_draw_text(char *text, vector_t center, double height, double width,
+                   color_t color) {
+  size_t n = strlen(text);
+  if (glyph_atlas == NULL) {
+    return;
+  }
+
+  // one quad per character, cut out of the atlas and tinted by the vertices
+  SDL_Color text_color = {color.r * 255, color.g * 255, color.b * 255,
+                          color.a * 255};
+  double glyph_count = LAST_GLYPH - FIRST_GLYPH + 1;
+  double left = center.x - width * n / 2;
+  double top = WINDOW_HEIGHT - center.y - height / 2;
+  begin_item(glyph_atlas, SDL_BLENDMODE_BLEND, 4 * n, 6 * n);
+  for (size_t i = 0; i < n; i++) {
+    char c = text[i];
+    if (c < FIRST_GLYPH || c > LAST_GLYPH || c == ' ') {
+      continue;
+    }
+    double x = left + i * width;
+    push_quad(x, top, x + width, top + height, (c - FIRST_GLYPH) / glyph_count,
+              0, (c - FIRST_GLYPH + 1) / glyph_count, 1, text_color);
+  }
+  end_item();
 }
 
-list_t *sdl_prepare_text(char* text, vector_t center, double height, double width, color_t color) {
-  // texture prep
-  SDL_Color text_color = {color.r*255, color.g*255, color.b*255, color.a*255};
-  SDL_Surface* message_surface = TTF_RenderText_Solid(font, text, text_color);
-  SDL_Texture* message_texture = SDL_CreateTextureFromSurface(renderer, message_surface);
-  
-  // rectangle prep (placement)
-  SDL_Rect *message_rectangle = malloc(sizeof(SDL_FRect));
-  message_rectangle->x = center.x - width / 2;
-  message_rectangle->y = WINDOW_HEIGHT - center.y - height / 2;
-  message_rectangle->w = width;
-  message_rectangle->h = height;
+void sdl_play_music(char *path) {
+  Mix_Music *sound = Mix_LoadMUS(path);
+  Mix_PlayMusic(sound, 0);
+}
 
-  list_t *l = list_init(2, NULL);
-  list_add(l, message_texture);
-  list_add(l, message_rectangle);
-  list_add(l, message_surface);
-  return l;
+void sound_free(void *sound) {
+  sound_t *s = (sound_t *)sound;
+  if (s->chunk != NULL) {
+    Mix_FreeChunk(s->chunk);
+  }
+  free(s->path);
+  free(s);
 }
 
-void sdl_render_text(list_t *l) {
-  SDL_Texture *message_texture = list_get(l, 0);
-  SDL_Rect *message_rectangle = list_get(l, 1);
-  SDL_RenderCopy(renderer, message_texture, NULL, message_rectangle);
-  sdl_show();
+/**
+ * Finds a sound file in the cache, loading it on first use.
+ * A file that fails to load is cached as NULL so it isn't retried every time.
+ */
+size_t sdl_load_sound(const char *path) {
+  if (sounds == NULL) {
+    sounds = list_init(1, sound_free);
+  }
+  for (size_t i = 0; i < list_size(sounds); i++) {
+    sound_t *sound = list_get(sounds, i);
+    if (strcmp(sound->path, path) == 0) {
+      return i;
+    }
+  }
+
+  sound_t *sound = malloc(sizeof(sound_t));
+  assert(sound != NULL);
+  sound->path = malloc(strlen(path) + 1);
+  assert(sound->path != NULL);
+  strcpy(sound->path, path);
+  sound->chunk = Mix_LoadWAV(path);
+  if (sound->chunk == NULL) {
+    printf("Could not load sound %s! SDL_mixer Error: %s\n", path,
+           Mix_GetError());
+  }
+  list_add(sounds, sound);
+  return list_size(sounds) - 1;
 }
 
-void sdl_free_text(list_t *l) { 
-  SDL_Texture *message_texture = (SDL_Texture *) list_get(l, 0);
-  SDL_Rect *message_rectangle = (SDL_Rect *) list_get(l, 1);
-  SDL_Surface *message_surface = (SDL_Surface *) list_get(l, 2);
-  SDL_FreeSurface(message_surface);
-  SDL_DestroyTexture(message_texture);
-  free(message_rectangle);
+void sdl_load_sounds(const char *paths[], size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    sdl_load_sound(paths[i]);
+  }
 }
 
-void sdl_play_music(char *path) {
-  Mix_Music *sound = Mix_LoadMUS(path);
-  Mix_PlayMusic(sound, 0);
+void sdl_play_loaded_sound(int channel, size_t sound, int loops) {
+  assert(sounds != NULL && sound < list_size(sounds));
+  Mix_Chunk *chunk = ((sound_t *)list_get(sounds, sound))->chunk;
+  if (chunk != NULL) {
+    Mix_PlayChannel(channel, chunk, loops);
+  }
 }
 
 void sdl_play_sound(int channel, char *path, int loops) {
-  Mix_Chunk *chunk = Mix_LoadWAV(path);
-  Mix_PlayChannel(channel, chunk, loops);
+  sdl_play_loaded_sound(channel, sdl_load_sound(path), loops);
 }
 
-void sdl_render_image() { 
-  SDL_Surface * image = SDL_LoadBMP("assets/background.bmp");
-  SDL_Texture * texture = SDL_CreateTextureFromSurface(renderer, image);
-  
-  SDL_RenderCopy(renderer, texture, NULL, NULL);
-  
-  SDL_RenderPresent(renderer);
-  sdl_show();
-  SDL_DestroyTexture(texture);
-  SDL_FreeSurface(image);
+void sdl_free_sounds(void) {
+  if (sounds == NULL) {
+    return;
+  }
+  // chunks can't be freed while they are playing
+  Mix_HaltChannel(-1);
+  list_free(sounds);
+  sounds = NULL;
+}
+
+void texture_free(void *texture) {
+  texture_t *t = (texture_t *)texture;
+  if (t->texture != NULL) {
+    backend->free_texture(t->texture);
+  }
+  free(t->path);
+  free(t);
+}
+
+size_t sdl_load_texture(const char *path) {
+  if (textures == NULL) {
+    textures = list_init(1, texture_free);
+  }
+  for (size_t i = 0; i < list_size(textures); i++) {
+    texture_t *texture = list_get(textures, i);
+    if (strcmp(texture->path, path) == 0) {
+      return i;
+    }
+  }
+
+  texture_t *texture = malloc(sizeof(texture_t));
+  assert(texture != NULL);
+  texture->path = malloc(strlen(path) + 1);
+  assert(texture->path != NULL);
+  strcpy(texture->path, path);
+  texture->texture = NULL;
+  SDL_Surface *image = SDL_LoadBMP(path);
+  if (image == NULL) {
+    printf("Could not load image %s! SDL Error: %s\n", path, SDL_GetError());
+  } else {
+    texture->texture = backend->create_texture(image);
+    SDL_FreeSurface(image);
+  }
+  list_add(textures, texture);
+  return list_size(textures) - 1;
+}
+
+/** Gets the texture behind a handle, or NULL if it failed to load */
+void *get_texture(size_t texture) {
+  assert(textures != NULL && texture < list_size(textures));
+  return ((texture_t *)list_get(textures, texture))->texture;
+}
+
+void sdl_draw_texture(size_t texture, vector_t center, double width,
+                      double height) {
+  void *backend_texture = get_texture(texture);
+  if (backend_texture == NULL) {
+    return;
+  }
+  vector_t pixel = get_window_position(center);
+  double half_width = width * view_scale / 2;
+  double half_height = height * view_scale / 2;
+  SDL_Color white = {255, 255, 255, 255};
+  begin_item(backend_texture, SDL_BLENDMODE_BLEND, 4, 6);
+  push_quad(pixel.x - half_width, pixel.y - half_height, pixel.x + half_width,
+            pixel.y + half_height, 0, 0, 1, 1, white);
+  end_item();
+}
+
+void sdl_draw_background(size_t texture) {
+  void *backend_texture = get_texture(texture);
+  if (backend_texture == NULL) {
+    return;
+  }
+  int width, height;
+  get_window_size(&width, &height);
+  SDL_Color white = {255, 255, 255, 255};
+  begin_item(backend_texture, SDL_BLENDMODE_BLEND, 4, 6);
+  push_quad(0, 0, width, height, 0, 0, 1, 1, white);
+  end_item();
+}
+
+void sdl_free_textures(void) {
+  if (textures == NULL) {
+    return;
+  }
+  list_free(textures);
+  textures = NULL;
 }
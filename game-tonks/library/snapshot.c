@@ -0,0 +1,274 @@
+#include "snapshot.h"
+
+#include "body.h"
+#include "list.h"
+#include "prototype.h"
+#include "scene.h"
+#include "sdl_wrapper.h"
+#include "text.h"
+#include "vector.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+  SNAPSHOT_BACKGROUND,
+  SNAPSHOT_POLYGON,
+  SNAPSHOT_PROTOTYPE,
+  SNAPSHOT_GLOW,
+  SNAPSHOT_DISC,
+  SNAPSHOT_TEXT
+} entry_kind_t;
+
+/**
+ * One thing to draw. Only the fields used by its kind are set.
+ */
+typedef struct entry {
+  entry_kind_t kind;
+  size_t id; // the serial of the body or text it was recorded from, or 0
+  uint32_t teleports; // body_get_teleports() of the body it was recorded from
+  vector_t center;
+  double angle;   // prototypes
+  double size;    // the radius of glows and discs, the height of texts
+  double width;   // the width of each character of texts
+  color_t color;
+  prototype_t *prototype;
+  size_t texture; // backgrounds
+  size_t first;   // the first vertex of polygons, the first character of texts
+  size_t count;   // the number of vertices of polygons
+  bounds_t bounds; // around polygons, relative to their centers
+} entry_t;
+
+typedef struct snapshot {
+  double time;
+  entry_t *entries;
+  size_t entry_count;
+  size_t entry_capacity;
+  vector_t *points; // polygon vertices, relative to their centers
+  size_t point_count;
+  size_t point_capacity;
+  char *chars; // texts, each followed by '\0'
+  size_t char_count;
+  size_t char_capacity;
+} snapshot_t;
+
+snapshot_t *snapshot_init(void) {
+  snapshot_t *snapshot = malloc(sizeof(*snapshot));
+  assert(snapshot != NULL);
+  *snapshot = (snapshot_t){.time = 0};
+  return snapshot;
+}
+
+void snapshot_free(snapshot_t *snapshot) {
+  free(snapshot->entries);
+  free(snapshot->points);
+  free(snapshot->chars);
+  free(snapshot);
+}
+
+void snapshot_clear(snapshot_t *snapshot, double time) {
+  snapshot->time = time;
+  snapshot->entry_count = 0;
+  snapshot->point_count = 0;
+  snapshot->char_count = 0;
+}
+
+double snapshot_get_time(snapshot_t *snapshot) { return snapshot->time; }
+
+/**
+ * Grows one of a snapshot's buffers so it can hold at least needed elements.
+ */
+void *snapshot_reserve(void *buffer, size_t *capacity, size_t needed,
+                       size_t element_size) {
+  if (needed <= *capacity) {
+    return buffer;
+  }
+  *capacity = *capacity * 2 > needed ? *capacity * 2 : needed;
+  buffer = realloc(buffer, element_size * *capacity);
+  assert(buffer != NULL);
+  return buffer;
+}
+
+/** Appends an entry of a given kind, returning it to be filled in */
+entry_t *add_entry(snapshot_t *snapshot, entry_kind_t kind, size_t id) {
+  snapshot->entries =
+      snapshot_reserve(snapshot->entries, &snapshot->entry_capacity,
+                       snapshot->entry_count + 1, sizeof(*snapshot->entries));
+  entry_t *entry = &snapshot->entries[snapshot->entry_count++];
+  *entry = (entry_t){.kind = kind, .id = id};
+  return entry;
+}
+
+void snapshot_add_background(snapshot_t *snapshot, size_t texture) {
+  add_entry(snapshot, SNAPSHOT_BACKGROUND, 0)->texture = texture;
+}
+
+void snapshot_add_bodies(snapshot_t *snapshot, scene_t *scene) {
+  for (size_t i = 0; i < scene_bodies(scene); i++) {
+    body_t *body = scene_get_body(scene, i);
+    if (body_is_removed(body)) {
+      continue;
+    }
+    prototype_t *prototype = body_get_prototype(body);
+    entry_t *entry =
+        add_entry(snapshot,
+                  prototype != NULL ? SNAPSHOT_PROTOTYPE : SNAPSHOT_POLYGON,
+                  body_get_serial(body));
+    entry->teleports = body_get_teleports(body);
+    entry->center = body_get_centroid(body);
+    entry->angle = body_get_rotation(body);
+    entry->color = body_get_color(body);
+    entry->prototype = prototype;
+    if (prototype != NULL) {
+      continue;
+    }
+    bounds_t bounds = body_get_bounds(body);
+    entry->bounds = (bounds_t){.min = vec_subtract(bounds.min, entry->center),
+                               .max = vec_subtract(bounds.max, entry->center)};
+
+    // bodies with their own shape are few (walls, menu buttons), so copying
+    // their vertices is cheap
+    list_t *shape = body_get_shape(body);
+    size_t n = list_size(shape);
+    snapshot->points =
+        snapshot_reserve(snapshot->points, &snapshot->point_capacity,
+                         snapshot->point_count + n, sizeof(*snapshot->points));
+    entry->first = snapshot->point_count;
+    entry->count = n;
+    for (size_t j = 0; j < n; j++) {
+      snapshot->points[snapshot->point_count++] =
+          vec_subtract(*(vector_t *)list_get(shape, j), entry->center);
+    }
+    list_free(shape);
+  }
+}
+
+void snapshot_add_glows(snapshot_t *snapshot, scene_t *scene) {
+  for (size_t i = 0; i < scene_bodies(scene); i++) {
+    body_t *body = scene_get_body(scene, i);
+    if (body_is_removed(body) || !body_get_glow(body)) {
+      continue;
+    }
+    entry_t *entry =
+        add_entry(snapshot, SNAPSHOT_GLOW, body_get_serial(body));
+    entry->teleports = body_get_teleports(body);
+    entry->center = body_get_centroid(body);
+    entry->size = body_get_glow_radius(body);
+    entry->color = body_get_color(body);
+  }
+}
+
+void snapshot_add_texts(snapshot_t *snapshot, scene_t *scene) {
+  list_t *texts = scene_get_texts(scene);
+  for (size_t i = 0; i < list_size(texts); i++) {
+    text_t *text = list_get(texts, i);
+    if (text->removed) {
+      continue;
+    }
+    size_t length = strlen(text->text) + 1;
+    snapshot->chars =
+        snapshot_reserve(snapshot->chars, &snapshot->char_capacity,
+                         snapshot->char_count + length, sizeof(char));
+    memcpy(&snapshot->chars[snapshot->char_count], text->text, length);
+
+    entry_t *entry = add_entry(snapshot, SNAPSHOT_TEXT, text->serial);
+    entry->center = text->center;
+    entry->size = text->height;
+    entry->width = text->width;
+    entry->color = text->color;
+    entry->first = snapshot->char_count;
+    snapshot->char_count += length;
+  }
+}
+
+void snapshot_add_disc(snapshot_t *snapshot, size_t id,
+                       uint32_t teleports, vector_t center, double radius,
+                       color_t color) {
+  entry_t *entry = add_entry(snapshot, SNAPSHOT_DISC, id);
+  entry->teleports = teleports;
+  entry->center = center;
+  entry->size = radius;
+  entry->color = color;
+}
+
+/**
+ * Finds the entry recorded from the same thing as another entry,
+ * matched by serial number rather than address, since a body freed
+ * between the snapshots may have had its address reused.
+ * Looks no earlier than *from in the snapshot. Things keep their order
+ * from one tick to the next (new ones are added after the old ones),
+ * so matching entries can be searched for from where the last one was found.
+ * Returns NULL if there is no such entry.
+ */
+entry_t *find_match(snapshot_t *snapshot, entry_t *entry, size_t *from) {
+  if (entry->id == 0) {
+    return NULL;
+  }
+  for (size_t i = *from; i < snapshot->entry_count; i++) {
+    entry_t *match = &snapshot->entries[i];
+    if (match->id == entry->id && match->kind == entry->kind) {
+      *from = i + 1;
+      return match;
+    }
+  }
+  return NULL;
+}
+
+/** Draws a polygon entry at a given center, unless it is outside the window */
+void draw_polygon_entry(snapshot_t *snapshot, entry_t *entry,
+                        vector_t center) {
+  if (!sdl_is_visible(vec_add(center, entry->bounds.min),
+                      vec_add(center, entry->bounds.max))) {
+    return;
+  }
+  list_t *points = list_init(entry->count, free);
+  for (size_t i = 0; i < entry->count; i++) {
+    vector_t *point = malloc(sizeof(*point));
+    assert(point != NULL);
+    *point = vec_add(center, snapshot->points[entry->first + i]);
+    list_add(points, point);
+  }
+  sdl_draw_polygon(points, entry->color);
+  list_free(points);
+}
+
+void snapshot_draw(snapshot_t *previous, snapshot_t *current, double alpha) {
+  size_t match_from = 0;
+  for (size_t i = 0; i < current->entry_count; i++) {
+    entry_t *entry = &current->entries[i];
+    vector_t center = entry->center;
+    double angle = entry->angle;
+    entry_t *before =
+        previous == NULL ? NULL : find_match(previous, entry, &match_from);
+    // a body that was teleported between the snapshots is drawn where it
+    // landed instead of sliding there
+    if (before != NULL && before->teleports == entry->teleports) {
+      center = vec_add(before->center,
+                       vec_multiply(alpha, vec_subtract(center,
+                                                        before->center)));
+      angle = before->angle + alpha * (angle - before->angle);
+    }
+
+    switch (entry->kind) {
+    case SNAPSHOT_BACKGROUND:
+      sdl_draw_background(entry->texture);
+      break;
+    case SNAPSHOT_POLYGON:
+      draw_polygon_entry(current, entry, center);
+      break;
+    case SNAPSHOT_PROTOTYPE:
+      sdl_draw_prototype(entry->prototype, center, angle, entry->color);
+      break;
+    case SNAPSHOT_GLOW:
+      sdl_draw_glow(center, entry->size, entry->color);
+      break;
+    case SNAPSHOT_DISC:
+      sdl_draw_disc(center, entry->size, entry->color);
+      break;
+    case SNAPSHOT_TEXT:
+      sdl_draw_text(&current->chars[entry->first], center, entry->size,
+                    entry->width, entry->color);
+      break;
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#include "spatial_hash.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+const size_t SPATIAL_HASH_BUCKETS = 256;
+const size_t DEFAULT_BUCKET_SIZE = 4;
+// large primes that scatter neighboring cells across the buckets
+const uint64_t CELL_HASH_X = 73856093;
+const uint64_t CELL_HASH_Y = 19349663;
+
+/** A body in a bucket, along with the cell it was filed under */
+typedef struct hash_entry {
+  body_t *body;
+  int64_t cell_x;
+  int64_t cell_y;
+} hash_entry_t;
+
+typedef struct spatial_hash {
+  double cell_size;
+  list_t **buckets; // lists of hash entries
+  size_t size;
+  // the farthest any inserted body's bounds reach from its centroid,
+  // so a query knows how many cells around it can hold bodies it touches
+  double max_extent;
+} spatial_hash_t;
+
+spatial_hash_t *spatial_hash_init(double cell_size) {
+  assert(cell_size > 0);
+  spatial_hash_t *hash = malloc(sizeof(spatial_hash_t));
+  assert(hash != NULL);
+  hash->cell_size = cell_size;
+  hash->buckets = malloc(sizeof(list_t *) * SPATIAL_HASH_BUCKETS);
+  assert(hash->buckets != NULL);
+  for (size_t i = 0; i < SPATIAL_HASH_BUCKETS; i++) {
+    hash->buckets[i] = list_init(DEFAULT_BUCKET_SIZE, free);
+  }
+  hash->size = 0;
+  hash->max_extent = 0;
+  return hash;
+}
+
+void spatial_hash_free(spatial_hash_t *hash) {
+  for (size_t i = 0; i < SPATIAL_HASH_BUCKETS; i++) {
+    list_free(hash->buckets[i]);
+  }
+  free(hash->buckets);
+  free(hash);
+}
+
+size_t spatial_hash_size(spatial_hash_t *hash) { return hash->size; }
+
+void spatial_hash_clear(spatial_hash_t *hash) {
+  for (size_t i = 0; i < SPATIAL_HASH_BUCKETS; i++) {
+    list_clear(hash->buckets[i]);
+  }
+  hash->size = 0;
+  hash->max_extent = 0;
+}
+
+/** The row or column of the cell containing a coordinate */
+int64_t spatial_hash_cell(spatial_hash_t *hash, double coordinate) {
+  return (int64_t)floor(coordinate / hash->cell_size);
+}
+
+list_t *spatial_hash_bucket(spatial_hash_t *hash, int64_t cell_x,
+                            int64_t cell_y) {
+  uint64_t key = ((uint64_t)cell_x * CELL_HASH_X) ^
+                 ((uint64_t)cell_y * CELL_HASH_Y);
+  return hash->buckets[key % SPATIAL_HASH_BUCKETS];
+}
+
+void spatial_hash_insert(spatial_hash_t *hash, body_t *body) {
+  vector_t centroid = body_get_centroid(body);
+  bounds_t bounds = body_get_bounds(body);
+  vector_t extent = vec_subtract(bounds.max, centroid);
+  vector_t extent_below = vec_subtract(centroid, bounds.min);
+  hash->max_extent =
+      fmax(hash->max_extent, fmax(fmax(extent.x, extent.y),
+                                  fmax(extent_below.x, extent_below.y)));
+
+  hash_entry_t *entry = malloc(sizeof(hash_entry_t));
+  assert(entry != NULL);
+  entry->body = body;
+  entry->cell_x = spatial_hash_cell(hash, centroid.x);
+  entry->cell_y = spatial_hash_cell(hash, centroid.y);
+  list_add(spatial_hash_bucket(hash, entry->cell_x, entry->cell_y), entry);
+  hash->size++;
+}
+
+bool spatial_hash_remove(spatial_hash_t *hash, body_t *body) {
+  vector_t centroid = body_get_centroid(body);
+  list_t *bucket =
+      spatial_hash_bucket(hash, spatial_hash_cell(hash, centroid.x),
+                          spatial_hash_cell(hash, centroid.y));
+  for (size_t i = 0; i < list_size(bucket); i++) {
+    hash_entry_t *entry = list_get(bucket, i);
+    if (entry->body == body) {
+      free(list_remove(bucket, i));
+      hash->size--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void spatial_hash_query(spatial_hash_t *hash, vector_t center, double radius,
+                        list_t *results) {
+  double reach = radius + hash->max_extent;
+  int64_t min_x = spatial_hash_cell(hash, center.x - reach);
+  int64_t max_x = spatial_hash_cell(hash, center.x + reach);
+  int64_t min_y = spatial_hash_cell(hash, center.y - reach);
+  int64_t max_y = spatial_hash_cell(hash, center.y + reach);
+  for (int64_t cell_x = min_x; cell_x <= max_x; cell_x++) {
+    for (int64_t cell_y = min_y; cell_y <= max_y; cell_y++) {
+      list_t *bucket = spatial_hash_bucket(hash, cell_x, cell_y);
+      for (size_t i = 0; i < list_size(bucket); i++) {
+        hash_entry_t *entry = list_get(bucket, i);
+        // other cells can share the bucket, and are visited on their own
+        if (entry->cell_x != cell_x || entry->cell_y != cell_y) {
+          continue;
+        }
+        bounds_t bounds = body_get_bounds(entry->body);
+        double dx = fmax(fmax(bounds.min.x - center.x, center.x - bounds.max.x),
+                         0);
+        double dy = fmax(fmax(bounds.min.y - center.y, center.y - bounds.max.y),
+                         0);
+        if (dx * dx + dy * dy <= radius * radius) {
+          list_add(results, entry->body);
+        }
+      }
+    }
+  }
+}
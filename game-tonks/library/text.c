@@ -5,6 +5,12 @@
 #include <string.h>
 #include "text.h"
 
+// enough digits for any size_t, and the '\0' after them
+const size_t NUMBER_TEXT_LENGTH = 21;
+
+// the serial of the next text allocated; 0 is never a text's serial
+size_t next_text_serial = 1;
+
 text_t *text_init(char *text, vector_t center, double height, double width, color_t color, double duration) {
   text_t *t = malloc(sizeof(text_t));
   t->text = text;
@@ -13,35 +19,67 @@ text_t *text_init(char *text, vector_t center, double height, double width, colo
   t->width = width;
   t->color = color;
   t->duration = duration;
-  t->texture = sdl_prepare_text(text, center, height, width * strlen(text), color);
   t->removed = false;
+  t->owns_text = true;
+  t->serial = next_text_serial++;
   return t;
 }
 
 void text_edit(text_t *t, char *new) {
-  // new text contents
-  free(t->text);
-  t->text = malloc(sizeof(char) * strlen(new));
+  if (t->owns_text) {
+    free(t->text);
+  }
+  t->text = malloc(sizeof(char) * (strlen(new) + 1));
   strcpy(t->text, new);
+  t->owns_text = true;
+}
+
+void text_set_static(text_t *t, const char *text) {
+  if (t->owns_text) {
+    free(t->text);
+  }
+  // never written through, since only texts from text_init_number() are
+  t->text = (char *)text;
+  t->owns_text = false;
+}
 
-  // new texture
-  sdl_free_text(t->texture);
-  t->texture = sdl_prepare_text(new, t->center, t->height, t->width * strlen(new), t->color);
+text_t *text_init_number(size_t number, vector_t center, double height, double width, color_t color, double duration) {
+  char *digits = malloc(sizeof(char) * NUMBER_TEXT_LENGTH);
+  digits[0] = '\0';
+  text_t *t = text_init(digits, center, height, width, color, duration);
+  text_set_number(t, number);
+  return t;
+}
+
+bool text_set_number(text_t *t, size_t number) {
+  size_t length = 1;
+  for (size_t rest = number / 10; rest > 0; rest /= 10) {
+    length++;
+  }
+  bool changed = length != strlen(t->text);
+  t->text[length] = '\0';
+  // fill in the digits from the last one, leaving the ones already shown
+  for (size_t i = length; i > 0; i--) {
+    char digit = '0' + number % 10;
+    number /= 10;
+    if (t->text[i - 1] != digit) {
+      t->text[i - 1] = digit;
+      changed = true;
+    }
+  }
+  return changed;
 }
 
 void text_set_color(text_t *t, color_t new_color) {
-  sdl_free_text(t->texture);
   t->color = new_color;
-  t->texture = sdl_prepare_text(t->text, t->center, t->height, t->width * strlen(t->text), new_color);
 }
 
 void text_move(text_t *t, vector_t pos) {
   t->center = pos;
-  sdl_move_text(t->texture, pos, t->height, t->width * strlen(t->text));
 }
 
 void text_render(text_t *t) {
-  sdl_render_text(t->texture);
+  sdl_draw_text(t->text, t->center, t->height, t->width, t->color);
 }
 
 void text_remove(text_t *t) {
@@ -51,6 +89,11 @@ void text_remove(text_t *t) {
   }
 }
 
+void text_show(text_t *t, double duration) {
+  t->removed = false;
+  t->duration = duration;
+}
+
 void text_tick(text_t *t, double dt) {
   if(t->duration != INFINITY) {
     t->duration -= dt;
@@ -59,15 +102,12 @@ void text_tick(text_t *t, double dt) {
       text_remove(t);
     }
   }
-  
-  if(!t->removed) {
-    text_render(t);
-  } 
 }
 
 void text_free(void *t) {
   text_t *t_casted = (text_t *)t;
-  sdl_free_text(t_casted->texture);
-  free(t_casted->text);
+  if (t_casted->owns_text) {
+    free(t_casted->text);
+  }
   free(t_casted);
 }
\ No newline at end of file